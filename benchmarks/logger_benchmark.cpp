@@ -0,0 +1,241 @@
+// Measures the cost of log_output and log_binary on the calling thread.
+//
+// Every run uses a null sink (no console, no file) so the numbers only cover
+// queueing and the logger thread keeping up, and the benchmark runs headless.
+// Producers don't wait for space, so messages past the queue are dropped. Latency
+// percentiles only cover the messages that were queued.
+//
+// Usage: logger_benchmark [output.json] [messages_per_thread]
+
+#include "core/heap.h"
+#include "core/logger.h"
+#include "core/platform/platform.h"
+
+#include <atomic>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const u32 DEFAULT_MESSAGES_PER_THREAD = 200000;
+static const u32 MAX_PRODUCERS = 16;
+
+enum class BenchmarkMode : u8
+{
+	BENCHMARK_MODE_TEXT,
+	BENCHMARK_MODE_BINARY
+};
+
+struct ProducerContext
+{
+	BenchmarkMode mode;
+	u32 thread_index;
+	u32 message_count;
+	u64* latencies;
+	u32 accepted_count;
+	std::atomic<bool>* start;
+};
+
+struct BenchmarkResult
+{
+	BenchmarkMode mode;
+	u32 thread_count;
+	u64 message_count;
+	u64 delivered_count;
+	u64 dropped_count;
+	f64 enqueue_seconds;
+	f64 total_seconds;
+	f64 p50_ns;
+	f64 p99_ns;
+	f64 p999_ns;
+	f64 max_ns;
+};
+
+static u32 producer_proc(void* data)
+{
+	ProducerContext* context = (ProducerContext*)data;
+
+	while (!context->start->load(std::memory_order_acquire))
+	{
+		yield_thread();
+	}
+
+	u32 accepted_count = 0;
+	for (u32 i = 0; i < context->message_count; ++i)
+	{
+		u64 begin = read_timestamp();
+		bool accepted;
+		if (context->mode == BenchmarkMode::BENCHMARK_MODE_TEXT)
+		{
+			accepted = log_output(LogLevel::LOG_LEVEL_TRACE, "Producer %u frame %u: drew %u instances in %.3f ms", context->thread_index, i, i * 3, 1.25);
+		}
+		else
+		{
+			accepted = log_binary(LogLevel::LOG_LEVEL_TRACE, "Producer %u frame %u: drew %u instances in %.3f ms", context->thread_index, i, i * 3, 1.25);
+		}
+		u64 end = read_timestamp();
+
+		// A dropped message only costs a failed claim, timing it would hide the real enqueue cost.
+		if (accepted)
+		{
+			context->latencies[accepted_count++] = end - begin;
+		}
+	}
+	context->accepted_count = accepted_count;
+
+	return 0;
+}
+
+static int compare_u64(const void* a, const void* b)
+{
+	u64 x = *(const u64*)a;
+	u64 y = *(const u64*)b;
+	return (x > y) - (x < y);
+}
+
+static f64 percentile_ns(const u64* sorted, u64 count, f64 percentile, f64 ticks_to_ns)
+{
+	if (count == 0)
+	{
+		return 0.0;
+	}
+	u64 index = (u64)(percentile * (f64)(count - 1));
+	return (f64)sorted[index] * ticks_to_ns;
+}
+
+static BenchmarkResult run_benchmark(BenchmarkMode mode, u32 thread_count, u32 messages_per_thread)
+{
+	LogConfig config = {};
+	config.console_output = false;
+	config.file_path = nullptr;
+	initialize_logging(&config);
+
+	u64 sample_count = (u64)thread_count * messages_per_thread;
+	u64* latencies = (u64*)malloc(sample_count * sizeof(u64));
+
+	std::atomic<bool> start(false);
+	PlatformThread threads[MAX_PRODUCERS];
+	ProducerContext contexts[MAX_PRODUCERS];
+	for (u32 i = 0; i < thread_count; ++i)
+	{
+		contexts[i].mode = mode;
+		contexts[i].thread_index = i;
+		contexts[i].message_count = messages_per_thread;
+		contexts[i].latencies = latencies + (u64)i * messages_per_thread;
+		contexts[i].accepted_count = 0;
+		contexts[i].start = &start;
+		create_thread(&threads[i], producer_proc, &contexts[i]);
+	}
+
+	u64 begin = read_timestamp();
+	start.store(true, std::memory_order_release);
+	for (u32 i = 0; i < thread_count; ++i)
+	{
+		join_thread(&threads[i], 0xFFFFFFFF);
+	}
+	u64 enqueue_end = read_timestamp();
+	flush_logging(10000);
+	u64 total_end = read_timestamp();
+
+	// Pack each producer's accepted samples together.
+	u64 accepted_count = 0;
+	for (u32 i = 0; i < thread_count; ++i)
+	{
+		memmove(latencies + accepted_count, contexts[i].latencies, contexts[i].accepted_count * sizeof(u64));
+		accepted_count += contexts[i].accepted_count;
+	}
+
+	f64 frequency = (f64)get_timestamp_frequency();
+	f64 ticks_to_ns = 1e9 / frequency;
+
+	BenchmarkResult result = {};
+	result.mode = mode;
+	result.thread_count = thread_count;
+	result.message_count = sample_count;
+	result.delivered_count = accepted_count;
+	result.dropped_count = sample_count - accepted_count;
+	result.enqueue_seconds = (f64)(enqueue_end - begin) / frequency;
+	result.total_seconds = (f64)(total_end - begin) / frequency;
+
+	qsort(latencies, accepted_count, sizeof(u64), compare_u64);
+	result.p50_ns = percentile_ns(latencies, accepted_count, 0.5, ticks_to_ns);
+	result.p99_ns = percentile_ns(latencies, accepted_count, 0.99, ticks_to_ns);
+	result.p999_ns = percentile_ns(latencies, accepted_count, 0.999, ticks_to_ns);
+	result.max_ns = percentile_ns(latencies, accepted_count, 1.0, ticks_to_ns);
+
+	free(latencies);
+	shutdown_logging();
+
+	return result;
+}
+
+int main(int argc, char** argv)
+{
+	// Per-message latencies are tens of nanoseconds, too fine for the OS clock.
+	initialize_clock();
+	initialize_heaps();
+
+	const char* output_path = (argc > 1) ? argv[1] : "logger_benchmark.json";
+	u32 messages_per_thread = (argc > 2) ? (u32)strtoul(argv[2], nullptr, 10) : DEFAULT_MESSAGES_PER_THREAD;
+	if (messages_per_thread == 0)
+	{
+		messages_per_thread = DEFAULT_MESSAGES_PER_THREAD;
+	}
+
+	const u32 thread_counts[] = { 1, 4, MAX_PRODUCERS };
+	const BenchmarkMode modes[] = { BenchmarkMode::BENCHMARK_MODE_TEXT, BenchmarkMode::BENCHMARK_MODE_BINARY };
+	const char* mode_names[] = { "text", "binary" };
+
+	BenchmarkResult results[6];
+	u32 result_count = 0;
+
+	printf("%-8s %8s %14s %10s %10s %10s %10s %8s\n", "mode", "threads", "delivered/sec", "p50 ns", "p99 ns", "p999 ns", "max ns", "dropped");
+	for (BenchmarkMode mode : modes)
+	{
+		for (u32 thread_count : thread_counts)
+		{
+			BenchmarkResult result = run_benchmark(mode, thread_count, messages_per_thread);
+			results[result_count++] = result;
+
+			printf("%-8s %8u %14.0f %10.0f %10.0f %10.0f %10.0f %7.1f%%\n", mode_names[(u8)mode], thread_count,
+				(f64)result.delivered_count / result.total_seconds, result.p50_ns, result.p99_ns, result.p999_ns, result.max_ns,
+				100.0 * (f64)result.dropped_count / (f64)result.message_count);
+		}
+	}
+
+	FILE* file = fopen(output_path, "w");
+	if (file == nullptr)
+	{
+		fprintf(stderr, "Failed to open %s\n", output_path);
+		return 1;
+	}
+
+	fprintf(file, "{\n");
+	fprintf(file, "  \"benchmark\": \"logger\",\n");
+	fprintf(file, "  \"messages_per_thread\": %u,\n", messages_per_thread);
+	fprintf(file, "  \"results\": [\n");
+	for (u32 i = 0; i < result_count; ++i)
+	{
+		BenchmarkResult* result = &results[i];
+		fprintf(file, "    {\n");
+		fprintf(file, "      \"mode\": \"%s\",\n", mode_names[(u8)result->mode]);
+		fprintf(file, "      \"threads\": %u,\n", result->thread_count);
+		fprintf(file, "      \"messages\": %llu,\n", (unsigned long long)result->message_count);
+		fprintf(file, "      \"delivered\": %llu,\n", (unsigned long long)result->delivered_count);
+		fprintf(file, "      \"dropped\": %llu,\n", (unsigned long long)result->dropped_count);
+		fprintf(file, "      \"drop_rate\": %.4f,\n", (f64)result->dropped_count / (f64)result->message_count);
+		fprintf(file, "      \"enqueue_seconds\": %.6f,\n", result->enqueue_seconds);
+		fprintf(file, "      \"total_seconds\": %.6f,\n", result->total_seconds);
+		fprintf(file, "      \"attempts_per_second\": %.0f,\n", (f64)result->message_count / result->enqueue_seconds);
+		fprintf(file, "      \"delivered_per_second\": %.0f,\n", (f64)result->delivered_count / result->total_seconds);
+		fprintf(file, "      \"latency_ns\": { \"p50\": %.1f, \"p99\": %.1f, \"p999\": %.1f, \"max\": %.1f }\n",
+			result->p50_ns, result->p99_ns, result->p999_ns, result->max_ns);
+		fprintf(file, "    }%s\n", (i + 1 < result_count) ? "," : "");
+	}
+	fprintf(file, "  ]\n");
+	fprintf(file, "}\n");
+	fclose(file);
+	shutdown_heaps();
+
+	printf("Results written to %s\n", output_path);
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,161 @@
+// Compares every memory function implementation the CPU supports against libc.
+//
+// Sizes up to 64KB cycle through a pool that fits in L2, so they measure the
+// functions themselves. Larger sizes cycle through a pool bigger than the last
+// level cache, so they measure memory bandwidth and show what streaming buys.
+//
+// Usage: memory_benchmark [output.json]
+
+#include "core/platform/platform.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Total bytes touched per measurement, spread across buffers of the tested size.
+static const u64 BYTES_PER_RUN = 128ull * 1024 * 1024;
+static const u64 CACHED_POOL_SIZE = 256ull * 1024;
+static const u64 CACHED_MAX_SIZE = 64ull * 1024;
+static const u64 POOL_SIZE = 64ull * 1024 * 1024;
+static const u32 RUNS = 3;
+
+enum class MemoryOperation : u8
+{
+	MEMORY_OPERATION_COPY,
+	MEMORY_OPERATION_STREAM_COPY,
+	MEMORY_OPERATION_SET,
+	MEMORY_OPERATION_COMPARE,
+	MEMORY_OPERATION_MAX_OPERATIONS
+};
+
+static const char* operation_names[(u32)MemoryOperation::MEMORY_OPERATION_MAX_OPERATIONS] = { "copy", "stream_copy", "set", "compare" };
+
+struct BenchmarkResult
+{
+	MemoryImplementation implementation;
+	MemoryOperation operation;
+	u64 size;
+	f64 gigabytes_per_second;
+};
+
+// Keeps the compiler from dropping compare results.
+static volatile s32 compare_sink;
+
+static f64 run_operation(MemoryOperation operation, u8* dest, u8* src, u64 size)
+{
+	u64 buffer_count = ((size <= CACHED_MAX_SIZE) ? CACHED_POOL_SIZE : POOL_SIZE) / size;
+	u64 iterations = BYTES_PER_RUN / size;
+	f64 best_seconds = 1e30;
+
+	for (u32 run = 0; run < RUNS; ++run)
+	{
+		u64 begin = get_performance_counter();
+		for (u64 i = 0; i < iterations; ++i)
+		{
+			u64 offset = (i % buffer_count) * size;
+			switch (operation)
+			{
+			case MemoryOperation::MEMORY_OPERATION_COPY:
+				copy_memory(dest + offset, src + offset, size);
+				break;
+			case MemoryOperation::MEMORY_OPERATION_STREAM_COPY:
+				stream_copy_memory(dest + offset, src + offset, size);
+				break;
+			case MemoryOperation::MEMORY_OPERATION_SET:
+				set_memory(dest + offset, (u8)i, size);
+				break;
+			case MemoryOperation::MEMORY_OPERATION_COMPARE:
+				compare_sink = compare_memory(dest + offset, src + offset, size);
+				break;
+			default:
+				break;
+			}
+		}
+		f64 seconds = (f64)(get_performance_counter() - begin) / (f64)get_performance_frequency();
+		if (seconds < best_seconds)
+		{
+			best_seconds = seconds;
+		}
+	}
+
+	return (f64)(iterations * size) / best_seconds / 1e9;
+}
+
+int main(int argc, char** argv)
+{
+	const char* output_path = (argc > 1) ? argv[1] : "memory_benchmark.json";
+
+	initialize_memory_functions();
+	MemoryImplementation best = get_memory_implementation();
+
+	u8* src = (u8*)malloc(POOL_SIZE + 64);
+	u8* dest = (u8*)malloc(POOL_SIZE + 64);
+	for (u64 i = 0; i < POOL_SIZE + 64; ++i)
+	{
+		src[i] = (u8)(i * 31);
+	}
+	memcpy(dest, src, POOL_SIZE + 64);
+
+	const u64 sizes[] = { 64, 256, 4096, 65536, 1024 * 1024, 16 * 1024 * 1024 };
+	const u32 size_count = sizeof(sizes) / sizeof(sizes[0]);
+
+	BenchmarkResult results[(u32)MemoryImplementation::MEMORY_IMPLEMENTATION_MAX_IMPLEMENTATIONS * (u32)MemoryOperation::MEMORY_OPERATION_MAX_OPERATIONS * 6];
+	u32 result_count = 0;
+
+	printf("Best supported: %s\n", get_memory_implementation_name(best));
+	printf("%-8s %-12s %10s %10s\n", "impl", "operation", "size", "GB/s");
+	for (u32 i = 0; i < (u32)MemoryImplementation::MEMORY_IMPLEMENTATION_MAX_IMPLEMENTATIONS; ++i)
+	{
+		MemoryImplementation implementation = (MemoryImplementation)i;
+		if (!select_memory_implementation(implementation))
+		{
+			continue;
+		}
+
+		for (u32 op = 0; op < (u32)MemoryOperation::MEMORY_OPERATION_MAX_OPERATIONS; ++op)
+		{
+			for (u32 s = 0; s < size_count; ++s)
+			{
+				// Offset the source by one byte so the unaligned paths are measured too.
+				memcpy(dest, src + 1, POOL_SIZE);
+				BenchmarkResult* result = &results[result_count++];
+				result->implementation = implementation;
+				result->operation = (MemoryOperation)op;
+				result->size = sizes[s];
+				result->gigabytes_per_second = run_operation(result->operation, dest, src + 1, sizes[s]);
+
+				printf("%-8s %-12s %10llu %10.2f\n", get_memory_implementation_name(implementation), operation_names[op],
+					(unsigned long long)sizes[s], result->gigabytes_per_second);
+			}
+		}
+	}
+	select_memory_implementation(best);
+
+	free(src);
+	free(dest);
+
+	FILE* file = fopen(output_path, "w");
+	if (file == nullptr)
+	{
+		fprintf(stderr, "Failed to open %s\n", output_path);
+		return 1;
+	}
+
+	fprintf(file, "{\n");
+	fprintf(file, "  \"benchmark\": \"memory\",\n");
+	fprintf(file, "  \"best_implementation\": \"%s\",\n", get_memory_implementation_name(best));
+	fprintf(file, "  \"results\": [\n");
+	for (u32 i = 0; i < result_count; ++i)
+	{
+		BenchmarkResult* result = &results[i];
+		fprintf(file, "    { \"implementation\": \"%s\", \"operation\": \"%s\", \"size\": %llu, \"gigabytes_per_second\": %.3f }%s\n",
+			get_memory_implementation_name(result->implementation), operation_names[(u32)result->operation],
+			(unsigned long long)result->size, result->gigabytes_per_second, (i + 1 < result_count) ? "," : "");
+	}
+	fprintf(file, "  ]\n");
+	fprintf(file, "}\n");
+	fclose(file);
+
+	printf("Results written to %s\n", output_path);
+	return 0;
+}
\ No newline at end of file
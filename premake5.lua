@@ -44,6 +44,26 @@ project "d3d12_renderer"
 			"PLATFORM_WINDOWS"
 		}
 
+	-- Headless build, the D3D12 renderer is swapped for the null renderer.
+	filter "system:linux"
+		kind "ConsoleApp"
+		cppdialect "c++17"
+
+		defines {
+			"PLATFORM_LINUX",
+			"RENDERER_NULL"
+		}
+
+		removefiles {
+			"src/renderer/renderer.cpp",
+			"src/renderer/d3d12_*",
+			"src/core/platform/win32/**"
+		}
+
+		links {
+			"pthread"
+		}
+
 	filter "configurations:Debug"
 			defines {
 				"RENDERER_DEBUG",
@@ -57,4 +77,117 @@ project "d3d12_renderer"
 
 	filter "configurations:Dist"
 			defines "RENDERER_DIST"
-			optimize "On"
\ No newline at end of file
+			optimize "On"
+
+project "log_decoder"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "c++17"
+
+	targetdir ("build/" .. outputdir .. "/%{prj.name}")
+	objdir ("bin-int/" .. outputdir .. "/%{prj.name}")
+
+	files {
+		"tools/log_decoder/**.cpp",
+		"src/core/logger_binary.h"
+	}
+
+	includedirs {
+		"src"
+	}
+
+	filter "configurations:Debug"
+			symbols "On"
+
+	filter "configurations:Release or Dist"
+			optimize "On"
+
+
+project "logger_benchmark"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "c++17"
+
+	targetdir ("build/" .. outputdir .. "/%{prj.name}")
+	objdir ("bin-int/" .. outputdir .. "/%{prj.name}")
+
+	files {
+		"benchmarks/logger_benchmark.cpp",
+		"src/core/heap.h",
+		"src/core/heap.cpp",
+		"src/core/intrinsics.h",
+		"src/core/logger.h",
+		"src/core/logger.cpp",
+		"src/core/logger_binary.h",
+		"src/core/memory_tracking.h",
+		"src/core/memory_tracking.cpp",
+		"src/core/platform/platform.h",
+		"src/core/platform/platform_clock.cpp",
+		"src/core/platform/win32/win32_platform.cpp",
+		"src/core/platform/posix/posix_platform.cpp"
+	}
+
+	includedirs {
+		"src"
+	}
+
+	filter "system:windows"
+		systemversion "latest"
+		defines {
+			"PLATFORM_WINDOWS"
+		}
+
+	filter "system:linux"
+		defines {
+			"PLATFORM_LINUX"
+		}
+		links {
+			"pthread"
+		}
+
+	filter "configurations:Debug"
+			symbols "On"
+
+	filter "configurations:Release or Dist"
+			optimize "On"
+
+project "memory_benchmark"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "c++17"
+
+	targetdir ("build/" .. outputdir .. "/%{prj.name}")
+	objdir ("bin-int/" .. outputdir .. "/%{prj.name}")
+
+	files {
+		"benchmarks/memory_benchmark.cpp",
+		"src/core/intrinsics.h",
+		"src/core/platform/platform.h",
+		"src/core/platform/platform_memory.cpp",
+		"src/core/platform/win32/win32_platform.cpp",
+		"src/core/platform/posix/posix_platform.cpp"
+	}
+
+	includedirs {
+		"src"
+	}
+
+	filter "system:windows"
+		systemversion "latest"
+		defines {
+			"PLATFORM_WINDOWS"
+		}
+
+	filter "system:linux"
+		defines {
+			"PLATFORM_LINUX"
+		}
+		links {
+			"pthread"
+		}
+
+	filter "configurations:Debug"
+			symbols "On"
+
+	filter "configurations:Release or Dist"
+			optimize "On"
@@ -1,108 +1,56 @@
 #include "core/application.h"
+#include "core/frame_arena.h"
 #include "core/input.h"
+#include "core/input_actions.h"
+#include "core/input_recording.h"
 #include "core/logger.h"
+#include "core/platform/platform.h"
+#include "core/scratch_arena.h"
 #include "renderer/renderer.h"
 
-static LRESULT CALLBACK WindowProc(HWND window, UINT message, WPARAM w_param, LPARAM l_param)
-{
-    switch (message)
-    {
-    case WM_DESTROY:
-    {
-        PostQuitMessage(0);
-        return 0;
-    }
-    case WM_KEYDOWN:
-    case WM_SYSKEYDOWN:
-    case WM_KEYUP:
-    case WM_SYSKEYUP:
-    {
-        // TODO: We need to handle repeat key down messages when holding a key. Currently we just do 
-        // nothing about it. We should add proper handling at some point.
-        bool pressed = (message == WM_KEYDOWN || message == WM_SYSKEYDOWN);
-        Key key = (Key)w_param;
-        process_key(key, pressed);
-        break;
-    }
-    case WM_MOUSEMOVE:
-    {
-        s32 x_pos = GET_X_LPARAM(l_param);
-        s32 y_pos = GET_Y_LPARAM(l_param);
-        process_mouse_move(x_pos, y_pos);
-        break;
-    }
-    case WM_LBUTTONDOWN:
-    case WM_MBUTTONDOWN:
-    case WM_RBUTTONDOWN:
-    case WM_LBUTTONUP:
-    case WM_MBUTTONUP:
-    case WM_RBUTTONUP:
-    {
-        bool pressed = (message == WM_LBUTTONDOWN || message == WM_MBUTTONDOWN || message == WM_RBUTTONDOWN);
-        Button button = Button::BUTTON_MAX_BUTTONS;
-        switch (message)
-        {
-        case WM_LBUTTONDOWN:
-        case WM_LBUTTONUP:
-        {
-            button = Button::BUTTON_LEFT;
-            break;
-        }
-        case WM_MBUTTONDOWN:
-        case WM_MBUTTONUP:
-        {
-            button = Button::BUTTON_MIDDLE;
-            break;
-        }
-        case WM_RBUTTONDOWN:
-        case WM_RBUTTONUP:
-        {
-            button = Button::BUTTON_RIGHT;
-            break;
-        }
-        }
-
-        if (button != Button::BUTTON_MAX_BUTTONS)
-        {
-            process_button(button, pressed);
-        }
-        break;
-    }
-    case WM_MOUSEWHEEL:
-    {
-        s32 z_delta = GET_WHEEL_DELTA_WPARAM(w_param);
-        if (z_delta != 0)
-        {
-            // Maybe pass raw delta to application layer and let it handle scaling
-            // and clamping.
-            z_delta = (z_delta < 0) ? -1 : 1;
-            process_mouse_wheel(z_delta);
-        }
-        break;
-    }
-    }
-    return DefWindowProcW(window, message, w_param, l_param);
-}
+#include <stdio.h>
 
 bool initialize(Application* app, ApplicationConfig& config)
 {
-    QueryPerformanceFrequency(&(app->frequency));
-    QueryPerformanceCounter(&(app->time));
+    take_memory_snapshot(&app->memory_baseline);
+    app->frame_count = 0;
+    app->stats_start_time = get_time_ns();
+    app->last_frame_time = app->stats_start_time;
+    reset_latency_histogram(&app->input_latency);
 
 	app->client_width  = config.client_width;
 	app->client_height = config.client_height;
 	app->pos_x         = config.pos_x;
 	app->pos_y         = config.pos_y;
 
-    if (!create_window(app))
+    if (!create_window(&app->window, config.name, app->pos_x, app->pos_y, app->client_width, app->client_height))
+    {
+        LOG_FATAL("Failed to create the application window.");
+        return false;
+    }
+
+    initialize_input();
+    initialize_actions();
+    load_action_bindings(ACTION_BINDINGS_DEFAULT_PATH);
+    if (config.input_replay_path)
+    {
+        start_input_replay(config.input_replay_path);
+    }
+    else if (config.input_record_path)
+    {
+        start_input_recording(config.input_record_path);
+    }
+
+    // Per-frame data such as the input events comes from these.
+    if (!initialize_frame_arenas(Renderer::FRAME_COUNT))
     {
-        // TODO: Log a message if we fail to create a window.
+        LOG_FATAL("Failed to reserve the frame arenas.");
         return false;
     }
 
-    if (app->renderer.initialize(app->client_width, app->client_height, app->window_handle))
+    if (app->renderer.initialize(app->client_width, app->client_height, app->window.handle))
     {
-        LOG_INFO("Renderer initialized successfully!");
+        LOG_CAT_INFO(RENDERER, "Renderer initialized successfully!");
     }
 
     LOG_INFO("Application initialized successfully!");
@@ -112,109 +60,96 @@ bool initialize(Application* app, ApplicationConfig& config)
 
 void shutdown(Application* app)
 {
-	// cleanup stuff like maybe destroy window(s).
     app->renderer.shutdown();
-}
-
-bool create_window(Application* app)
-{
-    WNDCLASSEXW window_class = {};
-    window_class.cbSize = sizeof(window_class);
-    window_class.lpfnWndProc = &WindowProc;
-    window_class.hInstance = GetModuleHandleW(nullptr);
-    window_class.hIcon = LoadIconW(nullptr, (LPCWSTR)IDI_APPLICATION);
-    window_class.hbrBackground = (HBRUSH)GetStockObject(BLACK_BRUSH);
-    window_class.lpszClassName = L"d3d12_renderer";
-
-    ATOM Atom = RegisterClassExW(&window_class);
-    Assert(Atom);
-
-    DWORD window_ex_style = WS_EX_APPWINDOW; //| WS_EX_NOREDIRECTIONBITMAP; // magic style to make DXGI_SWAP_EFFECT_FLIP_DISCARD not glitch on window resizing
-    DWORD window_style = WS_OVERLAPPEDWINDOW;
-
-    // Obtain the size of the border.
-    RECT border_rect = { 0, 0, 0, 0 };
-    AdjustWindowRectEx(&border_rect, window_style, 0, window_ex_style);
-
-    u32 window_pos_x = app->pos_x;
-    u32 window_pos_y = app->pos_y;
-    u32 window_width = app->client_width;
-    u32 window_height = app->client_height;
-
-    // In this case, the border rectangle is negative.
-    window_pos_x += border_rect.left;
-    window_pos_y += border_rect.top;
-
-    // Grow by the size of the OS border.
-    window_width += border_rect.right - border_rect.left;
-    window_height += border_rect.bottom - border_rect.top;
-
-    app->window_handle = CreateWindowExW(
-        window_ex_style, window_class.lpszClassName, L"D3D12 Renderer", window_style,
-        window_pos_x, window_pos_y, window_width, window_height,
-        nullptr, nullptr, window_class.hInstance, nullptr);
-    Assert(app->window_handle);
-
-    ShowWindow(app->window_handle, SW_SHOWDEFAULT);
-
-    return true;
+    shutdown_frame_arenas();
+    shutdown_input();
+    destroy_window(&app->window);
+
+    // Everything the application allocated should be gone by now. The main
+    // thread's scratch arenas would otherwise look like a leak.
+    release_scratch_arenas();
+    MemorySnapshot live;
+    take_memory_snapshot(&live);
+    diff_memory_snapshots(&app->memory_baseline, &live, &live);
+    write_memory_snapshot(MEMORY_DUMP_DEFAULT_PATH, &live);
+    if (live.total.count != 0 || live.total.bytes != 0)
+    {
+        LOG_CAT_WARN(MEMORY, "%lld allocations (%lld bytes) made by the application are still live, see %s.", live.total.count, live.total.bytes, MEMORY_DUMP_DEFAULT_PATH);
+    }
 }
 
 bool run(Application* app)
 {
     for (;;)
     {
-        process_input();
+        begin_frame_arena();
+
+        if (!pump_messages())
+        {
+            break;
+        }
+
+        u64 now = get_time_ns();
+        f64 delta_time = (f64)(now - app->last_frame_time) * 1e-9;
+        app->last_frame_time = now;
+        update_input(delta_time);
+        update_actions();
 
         app->renderer.update();
         app->renderer.render();
 
-#if RENDERER_DEBUG
-        update_debug_stats(app->window_handle, app->frame_count, app->frequency, app->time);
-#endif
-    }
-    return true;
-}
-
-void process_input()
-{
-    MSG message = {};
+        // Events are in arrival order so the first one has waited the longest.
+        u32 event_count;
+        const InputEvent* events = get_input_events(&event_count);
+        if (event_count > 0)
+        {
+            f64 latency_ms = timestamp_to_ms((s64)(app->renderer.last_present_time - events[0].timestamp));
+            add_latency_sample(&app->input_latency, latency_ms);
+        }
 
-    while (PeekMessageW(&message, nullptr, 0, 0, PM_REMOVE))
-    {
-        if (message.message == WM_QUIT)
+        if (is_input_replay_finished())
         {
-            ExitProcess(0);
+            LOG_INFO("Input replay finished, exiting.");
+            break;
         }
-        TranslateMessage(&message);
-        DispatchMessageW(&message);
+
+#if RENDERER_DEBUG
+        update_debug_stats(&app->window, app->frame_count, app->stats_start_time, &app->input_latency);
+#endif
     }
+    return true;
 }
 
-void update_debug_stats(HWND window_handle, u32& frame_count, LARGE_INTEGER frequency, LARGE_INTEGER& time)
+void update_debug_stats(PlatformWindow* window, u32& frame_count, u64& stats_start_time, LatencyHistogram* input_latency)
 {
-    RECT rect;
-    GetClientRect(window_handle, &rect);
-
-    DWORD rect_width  = rect.right - rect.left;
-    DWORD rect_height = rect.bottom - rect.top;
     frame_count++;
 
-    u64 update_title = time.QuadPart + frequency.QuadPart;
-
-    LARGE_INTEGER now;
-    QueryPerformanceCounter(&now);
-    if (now.QuadPart > update_title)
+    u64 now = get_time_ns();
+    if (now > stats_start_time + 1000000000ull)
     {
-        update_title = now.QuadPart + frequency.QuadPart;
-
-        double frames_per_second = (double)frame_count * frequency.QuadPart / (now.QuadPart - time.QuadPart);
-        time = now;
+        f64 frames_per_second = (f64)frame_count * 1e9 / (f64)(now - stats_start_time);
+        stats_start_time = now;
         frame_count = 0;
 
-        WCHAR title[1024];
-        wsprintfW(title, L"D3D12 Renderer | Window Size: %dx%d | FPS: %d.%02d", rect_width, rect_height, 
-            (s32)frames_per_second, (s32)(frames_per_second * 100) % 100);
-        SetWindowTextW(window_handle, title);
+        u32 client_width, client_height;
+        get_window_client_size(window, &client_width, &client_height);
+
+        ScratchScope scratch;
+        MemorySnapshot* memory = allocate_array<MemorySnapshot>(scratch.arena, 1);
+        take_memory_snapshot(memory);
+        const f64 to_mb = 1.0 / (1024.0 * 1024.0);
+
+        char title[1024];
+        snprintf(title, sizeof(title), "D3D12 Renderer | Window Size: %ux%u | FPS: %.2f | Input Latency p50: %.2f ms p99: %.2f ms | CPU Memory: %.1f MB (renderer %.1f, assets %.1f, logging %.1f, frame %.1f, scratch %.1f)",
+            client_width, client_height, frames_per_second,
+            get_latency_percentile(input_latency, 0.5), get_latency_percentile(input_latency, 0.99),
+            (f64)memory->total.bytes * to_mb,
+            (f64)memory->tags[(u8)MemoryTag::MEMORY_TAG_RENDERER].bytes * to_mb,
+            (f64)memory->tags[(u8)MemoryTag::MEMORY_TAG_ASSETS].bytes * to_mb,
+            (f64)memory->tags[(u8)MemoryTag::MEMORY_TAG_LOGGING].bytes * to_mb,
+            (f64)memory->tags[(u8)MemoryTag::MEMORY_TAG_FRAME].bytes * to_mb,
+            (f64)memory->tags[(u8)MemoryTag::MEMORY_TAG_SCRATCH].bytes * to_mb);
+        set_window_title(window, title);
+        reset_latency_histogram(input_latency);
     }
 }
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "core/core_types.h"
+#include "core/latency_histogram.h"
+#include "core/memory_tracking.h"
+#include "core/platform/platform.h"
+#include "renderer/renderer.h"
+
+struct ApplicationConfig
+{
+	u32 client_width;
+	u32 client_height;
+	u32 pos_x;
+	u32 pos_y;
+	const char* name;
+
+	// Optional, see core/input_recording.h.
+	const char* input_record_path;
+	const char* input_replay_path;
+};
+
+struct Application
+{
+	u32 client_width;
+	u32 client_height;
+	u32 pos_x;
+	u32 pos_y;
+	PlatformWindow window;
+
+	u64 last_frame_time; // get_time_ns().
+
+	// Debug stats.
+	u32 frame_count;
+	u64 stats_start_time; // get_time_ns() when the current FPS window started.
+	// Time from the oldest event consumed in a frame to that frame's Present.
+	LatencyHistogram input_latency;
+	// Taken at the start of initialize, shutdown dumps whatever is still live since.
+	MemorySnapshot memory_baseline;
+
+	Renderer renderer;
+};
+
+bool initialize(Application* app, ApplicationConfig& config);
+
+void shutdown(Application* app);
+
+bool run(Application* app);
+
+void update_debug_stats(PlatformWindow* window, u32& frame_count, u64& stats_start_time, LatencyHistogram* input_latency);
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include "core/arena.h"
+#include "core/logger.h"
+#include "core/platform/platform.h"
+
+static u64 align_up(u64 value, u64 alignment)
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+bool create_arena(Arena* arena, const char* name, u64 reserve_size, MemorySiteId site, bool large_pages)
+{
+	*arena = {};
+
+	// Large page reservations must be a whole number of large pages.
+	u64 granularity = ARENA_COMMIT_GRANULARITY;
+	u64 large_page_size = get_large_page_size();
+	if (large_pages && large_page_size > granularity)
+	{
+		granularity = large_page_size;
+	}
+	reserve_size = align_up(reserve_size, granularity);
+
+	arena->base = (u8*)reserve_memory(reserve_size, large_pages);
+	if (arena->base == nullptr)
+	{
+		LOG_CAT_ERROR(MEMORY, "Failed to reserve %llu bytes for the %s arena.", reserve_size, name);
+		return false;
+	}
+
+	arena->reserved_size = reserve_size;
+	arena->name = name;
+	arena->site = site;
+	track_memory(site, 0, 1);
+	return true;
+}
+
+void destroy_arena(Arena* arena)
+{
+	if (arena->base != nullptr)
+	{
+		release_memory(arena->base, arena->reserved_size);
+		track_memory(arena->site, -(s64)arena->committed_size, -1);
+	}
+	*arena = {};
+}
+
+void* allocate_from_arena(Arena* arena, u64 size, u64 alignment)
+{
+	Assert((alignment & (alignment - 1)) == 0);
+
+	u64 offset = align_up(arena->used, alignment);
+	u64 end = offset + size;
+	if (end > arena->reserved_size || end < offset)
+	{
+		LOG_CAT_ERROR(MEMORY, "The %s arena is out of space, %llu of %llu bytes used.", arena->name, arena->used, arena->reserved_size);
+		return nullptr;
+	}
+
+	if (end > arena->committed_size)
+	{
+		u64 commit_end = align_up(end, ARENA_COMMIT_GRANULARITY);
+		if (commit_end > arena->reserved_size)
+		{
+			commit_end = arena->reserved_size;
+		}
+
+		if (!commit_memory(arena->base + arena->committed_size, commit_end - arena->committed_size))
+		{
+			LOG_CAT_ERROR(MEMORY, "Failed to commit %llu bytes for the %s arena.", commit_end - arena->committed_size, arena->name);
+			return nullptr;
+		}
+		track_memory(arena->site, (s64)(commit_end - arena->committed_size), 0);
+		arena->committed_size = commit_end;
+	}
+
+	arena->used = end;
+	if (end > arena->high_water)
+	{
+		arena->high_water = end;
+	}
+	return arena->base + offset;
+}
+
+u64 get_arena_position(const Arena* arena)
+{
+	return arena->used;
+}
+
+void pop_arena_to(Arena* arena, u64 position)
+{
+	Assert(position <= arena->used);
+	arena->used = position;
+}
+
+void reset_arena(Arena* arena)
+{
+	arena->used = 0;
+}
+
+void shrink_arena(Arena* arena, u64 keep_size)
+{
+	u64 keep = align_up(arena->used > keep_size ? arena->used : keep_size, ARENA_COMMIT_GRANULARITY);
+	if (keep < arena->committed_size)
+	{
+		decommit_memory(arena->base + keep, arena->committed_size - keep);
+		track_memory(arena->site, -(s64)(arena->committed_size - keep), 0);
+		arena->committed_size = keep;
+	}
+}
\ No newline at end of file
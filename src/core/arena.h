@@ -0,0 +1,42 @@
+#pragma once
+
+#include "core/core_types.h"
+#include "core/memory_tracking.h"
+
+// A linear allocator over a virtual memory reservation. The reservation is the
+// most the arena can ever hold, pages are committed as allocations reach them,
+// so an arena grows in place and never moves or copies what's already in it.
+#define ARENA_COMMIT_GRANULARITY (64 * 1024)
+#define ARENA_DEFAULT_ALIGNMENT 16
+
+struct Arena
+{
+	u8* base;
+	u64 reserved_size;
+	u64 committed_size;
+	u64 used;
+	u64 high_water; // Most bytes ever used, for sizing reservations.
+	const char* name;
+	MemorySiteId site; // Committed bytes are counted against this site.
+};
+
+bool create_arena(Arena* arena, const char* name, u64 reserve_size, MemorySiteId site, bool large_pages = false);
+void destroy_arena(Arena* arena);
+
+// Returns nullptr once the reservation is exhausted. Memory is not cleared.
+void* allocate_from_arena(Arena* arena, u64 size, u64 alignment = ARENA_DEFAULT_ALIGNMENT);
+
+template <typename T>
+T* allocate_array(Arena* arena, u64 count)
+{
+	return (T*)allocate_from_arena(arena, sizeof(T) * count, alignof(T) > ARENA_DEFAULT_ALIGNMENT ? alignof(T) : ARENA_DEFAULT_ALIGNMENT);
+}
+
+// Positions let a caller free everything allocated after a point.
+u64 get_arena_position(const Arena* arena);
+void pop_arena_to(Arena* arena, u64 position);
+// Frees everything but keeps the pages committed for reuse.
+void reset_arena(Arena* arena);
+// Returns the committed pages past the used bytes (rounded up to the commit
+// granularity) to the OS, keeping at least keep_size committed.
+void shrink_arena(Arena* arena, u64 keep_size = 0);
\ No newline at end of file
@@ -1,6 +1,12 @@
 #pragma once
 
-#define Assert(cond) do { if (!(cond)) __debugbreak(); } while (0)
+#if defined(_MSC_VER)
+#define DEBUG_BREAK() __debugbreak()
+#else
+#define DEBUG_BREAK() __builtin_trap()
+#endif
+
+#define Assert(cond) do { if (!(cond)) DEBUG_BREAK(); } while (0)
 
 // Unsigned types.
 typedef unsigned char      u8;
@@ -0,0 +1,51 @@
+#include "core/frame_arena.h"
+
+#include <stdio.h>
+
+struct FrameArenas
+{
+	Arena arenas[FRAME_ARENA_MAX_FRAMES];
+	char names[FRAME_ARENA_MAX_FRAMES][16];
+	u32 frame_count;
+	u32 index;
+};
+
+static FrameArenas frame_arenas = {};
+
+bool initialize_frame_arenas(u32 frame_count)
+{
+	Assert(frame_count > 0 && frame_count <= FRAME_ARENA_MAX_FRAMES);
+
+	frame_arenas = {};
+	for (u32 i = 0; i < frame_count; ++i)
+	{
+		snprintf(frame_arenas.names[i], sizeof(frame_arenas.names[i]), "frame %u", i);
+		if (!create_arena(&frame_arenas.arenas[i], frame_arenas.names[i], FRAME_ARENA_RESERVE_SIZE, MEMORY_SITE(FRAME)))
+		{
+			shutdown_frame_arenas();
+			return false;
+		}
+		frame_arenas.frame_count = i + 1;
+	}
+	return true;
+}
+
+void shutdown_frame_arenas()
+{
+	for (u32 i = 0; i < frame_arenas.frame_count; ++i)
+	{
+		destroy_arena(&frame_arenas.arenas[i]);
+	}
+	frame_arenas = {};
+}
+
+void begin_frame_arena()
+{
+	frame_arenas.index = (frame_arenas.index + 1) % frame_arenas.frame_count;
+	reset_arena(&frame_arenas.arenas[frame_arenas.index]);
+}
+
+Arena* get_frame_arena()
+{
+	return &frame_arenas.arenas[frame_arenas.index];
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "core/arena.h"
+#include "core/core_types.h"
+
+// Per-frame scratch memory. There is one arena per frame in flight and the run
+// loop moves to the next one at the top of every frame, resetting it. Anything
+// allocated from get_frame_arena() stays valid for frame_count frames, long enough
+// for the GPU to be done with a frame's uploads, then it is reused without a free.
+#define FRAME_ARENA_MAX_FRAMES 4
+#define FRAME_ARENA_RESERVE_SIZE (64ull * 1024 * 1024)
+
+bool initialize_frame_arenas(u32 frame_count);
+void shutdown_frame_arenas();
+// Switches to the next frame's arena and resets it.
+void begin_frame_arena();
+Arena* get_frame_arena();
+
+template <typename T>
+T* allocate_frame_array(u64 count)
+{
+	return allocate_array<T>(get_frame_arena(), count);
+}
\ No newline at end of file
@@ -0,0 +1,473 @@
+#include "core/heap.h"
+#include "core/intrinsics.h"
+#include "core/logger.h"
+#include "core/platform/platform.h"
+
+#include <stddef.h>
+#include <string.h>
+
+struct HeapBlock
+{
+	HeapBlock* prev_physical;
+	// Payload bytes, a multiple of 16. Bit 0 is set while the block is free, an
+	// allocated block keeps its MemorySiteId in the bits above the largest size.
+	u64 size;
+
+	// Free blocks only, these overlap the payload.
+	HeapBlock* next_free;
+	HeapBlock* prev_free;
+};
+
+#define HEAP_BLOCK_FREE 1ull
+#define HEAP_BLOCK_SITE_SHIFT HEAP_FIRST_LEVEL_MAX_BITS
+#define HEAP_BLOCK_SIZE_MASK (((1ull << HEAP_BLOCK_SITE_SHIFT) - 1) & ~HEAP_BLOCK_FREE)
+#define HEAP_BLOCK_HEADER_SIZE offsetof(HeapBlock, next_free)
+// A free block's payload must hold its list links.
+#define HEAP_MIN_PAYLOAD_SIZE (sizeof(HeapBlock) - HEAP_BLOCK_HEADER_SIZE)
+#define HEAP_MIN_BLOCK_SIZE sizeof(HeapBlock)
+
+static_assert(HEAP_BLOCK_HEADER_SIZE == HEAP_DEFAULT_ALIGNMENT, "Payloads must stay aligned to HEAP_DEFAULT_ALIGNMENT.");
+static_assert(HEAP_BLOCK_SITE_SHIFT + sizeof(MemorySiteId) * 8 <= 64, "Site ids must fit above the block size.");
+static_assert(HEAP_FIRST_LEVEL_COUNT <= 32 && HEAP_SECOND_LEVEL_COUNT <= 32, "Bitmaps are 32 bits.");
+
+struct Heaps
+{
+	Heap heaps[(u8)HeapId::HEAP_ID_MAX];
+};
+
+static Heaps heaps;
+
+static const char* heap_names[(u8)HeapId::HEAP_ID_MAX] = { "renderer", "assets", "logging" };
+
+// Only address space, pages are committed as each heap grows.
+static const u64 heap_reserve_sizes[(u8)HeapId::HEAP_ID_MAX] =
+{
+	256ull * 1024 * 1024,
+	1024ull * 1024 * 1024,
+	16ull * 1024 * 1024
+};
+
+static u64 align_up(u64 value, u64 alignment)
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static u64 get_block_size(const HeapBlock* block)
+{
+	return block->size & HEAP_BLOCK_SIZE_MASK;
+}
+
+static bool is_block_free(const HeapBlock* block)
+{
+	return (block->size & HEAP_BLOCK_FREE) != 0;
+}
+
+static u8* get_block_payload(HeapBlock* block)
+{
+	return (u8*)block + HEAP_BLOCK_HEADER_SIZE;
+}
+
+static HeapBlock* get_payload_block(const void* ptr)
+{
+	return (HeapBlock*)((u8*)ptr - HEAP_BLOCK_HEADER_SIZE);
+}
+
+static HeapBlock* get_next_block(HeapBlock* block)
+{
+	return (HeapBlock*)(get_block_payload(block) + get_block_size(block));
+}
+
+static void get_size_class(u64 size, u32* first_level, u32* second_level)
+{
+	if (size < HEAP_SMALL_BLOCK_SIZE)
+	{
+		*first_level = 0;
+		*second_level = (u32)(size >> HEAP_ALIGNMENT_BITS);
+		return;
+	}
+
+	u32 top_bit = find_last_set_u64(size);
+	*second_level = (u32)(size >> (top_bit - HEAP_SECOND_LEVEL_BITS)) ^ HEAP_SECOND_LEVEL_COUNT;
+	*first_level = top_bit - (HEAP_SECOND_LEVEL_BITS + HEAP_ALIGNMENT_BITS) + 1;
+}
+
+// Rounds a request up to the start of the next class, so any block in the class
+// get_size_class picks is big enough without walking the list.
+static u64 round_up_to_size_class(u64 size)
+{
+	if (size < HEAP_SMALL_BLOCK_SIZE)
+	{
+		return size;
+	}
+	u64 step = 1ull << (find_last_set_u64(size) - HEAP_SECOND_LEVEL_BITS);
+	return (size + step - 1) & ~(step - 1);
+}
+
+static void insert_free_block(Heap* heap, HeapBlock* block)
+{
+	u32 first_level, second_level;
+	get_size_class(get_block_size(block), &first_level, &second_level);
+
+	HeapBlock* head = heap->free_lists[first_level][second_level];
+	block->next_free = head;
+	block->prev_free = nullptr;
+	if (head)
+	{
+		head->prev_free = block;
+	}
+	heap->free_lists[first_level][second_level] = block;
+	heap->first_level_bitmap |= 1u << first_level;
+	heap->second_level_bitmaps[first_level] |= 1u << second_level;
+}
+
+static void remove_free_block(Heap* heap, HeapBlock* block)
+{
+	u32 first_level, second_level;
+	get_size_class(get_block_size(block), &first_level, &second_level);
+
+	if (block->prev_free)
+	{
+		block->prev_free->next_free = block->next_free;
+	}
+	else
+	{
+		heap->free_lists[first_level][second_level] = block->next_free;
+	}
+	if (block->next_free)
+	{
+		block->next_free->prev_free = block->prev_free;
+	}
+
+	if (heap->free_lists[first_level][second_level] == nullptr)
+	{
+		heap->second_level_bitmaps[first_level] &= ~(1u << second_level);
+		if (heap->second_level_bitmaps[first_level] == 0)
+		{
+			heap->first_level_bitmap &= ~(1u << first_level);
+		}
+	}
+}
+
+// size must already be rounded with round_up_to_size_class.
+static HeapBlock* find_free_block(Heap* heap, u64 size)
+{
+	u32 first_level, second_level;
+	get_size_class(size, &first_level, &second_level);
+	if (first_level >= HEAP_FIRST_LEVEL_COUNT)
+	{
+		return nullptr;
+	}
+
+	u32 second_level_map = heap->second_level_bitmaps[first_level] & (u32)(~0ull << second_level);
+	if (second_level_map == 0)
+	{
+		u32 first_level_map = heap->first_level_bitmap & (u32)(~0ull << (first_level + 1));
+		if (first_level_map == 0)
+		{
+			return nullptr;
+		}
+		first_level = count_trailing_zeros_u64(first_level_map);
+		second_level_map = heap->second_level_bitmaps[first_level];
+	}
+	second_level = count_trailing_zeros_u64(second_level_map);
+	return heap->free_lists[first_level][second_level];
+}
+
+// Merges a newly free block with its free neighbours and lists the result.
+static void release_block(Heap* heap, HeapBlock* block)
+{
+	block->size |= HEAP_BLOCK_FREE;
+
+	HeapBlock* prev = block->prev_physical;
+	if (prev && is_block_free(prev))
+	{
+		remove_free_block(heap, prev);
+		prev->size += HEAP_BLOCK_HEADER_SIZE + get_block_size(block);
+		block = prev;
+	}
+
+	HeapBlock* next = get_next_block(block);
+	if (is_block_free(next))
+	{
+		remove_free_block(heap, next);
+		block->size += HEAP_BLOCK_HEADER_SIZE + get_block_size(next);
+		next = get_next_block(block);
+	}
+
+	next->prev_physical = block;
+	insert_free_block(heap, block);
+}
+
+// Splits the bytes past size off into a free block. The block's next neighbour
+// is never free, free blocks are always merged, so the tail needs no merge.
+static void trim_block(Heap* heap, HeapBlock* block, u64 size)
+{
+	u64 block_size = get_block_size(block);
+	if (block_size - size < HEAP_MIN_BLOCK_SIZE)
+	{
+		return;
+	}
+
+	HeapBlock* tail = (HeapBlock*)(get_block_payload(block) + size);
+	tail->prev_physical = block;
+	tail->size = (block_size - size - HEAP_BLOCK_HEADER_SIZE) | HEAP_BLOCK_FREE;
+	block->size = size | (block->size & HEAP_BLOCK_FREE);
+	get_next_block(tail)->prev_physical = tail;
+	insert_free_block(heap, tail);
+}
+
+// Commits enough of the reservation for a free block of at least size bytes.
+static bool grow_heap(Heap* heap, u64 size)
+{
+	u64 grow_size = align_up(size + HEAP_BLOCK_HEADER_SIZE, HEAP_COMMIT_GRANULARITY);
+	if (grow_size > heap->reserved_size - heap->committed_size)
+	{
+		grow_size = heap->reserved_size - heap->committed_size;
+	}
+	if (grow_size == 0)
+	{
+		return false;
+	}
+
+	if (!commit_memory(heap->base + heap->committed_size, grow_size))
+	{
+		LOG_CAT_ERROR(MEMORY, "Failed to commit %llu bytes for the %s heap.", grow_size, heap->name);
+		return false;
+	}
+	heap->committed_size += grow_size;
+
+	// The old sentinel's header starts the new block.
+	HeapBlock* block = heap->sentinel;
+	block->size = grow_size - HEAP_BLOCK_HEADER_SIZE;
+
+	HeapBlock* sentinel = get_next_block(block);
+	sentinel->prev_physical = block;
+	sentinel->size = 0;
+	heap->sentinel = sentinel;
+
+	release_block(heap, block);
+	return true;
+}
+
+static void lock_heap(Heap* heap)
+{
+	while (heap->locked.exchange(true, std::memory_order_acquire))
+	{
+		while (heap->locked.load(std::memory_order_relaxed))
+		{
+			yield_thread();
+		}
+	}
+}
+
+static void unlock_heap(Heap* heap)
+{
+	heap->locked.store(false, std::memory_order_release);
+}
+
+static void clear_heap(Heap* heap)
+{
+	heap->base = nullptr;
+	heap->reserved_size = 0;
+	heap->committed_size = 0;
+	heap->used = 0;
+	heap->high_water = 0;
+	heap->allocation_count = 0;
+	heap->name = nullptr;
+	heap->sentinel = nullptr;
+	heap->first_level_bitmap = 0;
+	memset(heap->second_level_bitmaps, 0, sizeof(heap->second_level_bitmaps));
+	memset(heap->free_lists, 0, sizeof(heap->free_lists));
+	heap->locked.store(false, std::memory_order_relaxed);
+}
+
+bool create_heap(Heap* heap, const char* name, u64 reserve_size)
+{
+	clear_heap(heap);
+
+	reserve_size = align_up(reserve_size > 0 ? reserve_size : 1, HEAP_COMMIT_GRANULARITY);
+	Assert(reserve_size < (1ull << HEAP_FIRST_LEVEL_MAX_BITS));
+
+	heap->base = (u8*)reserve_memory(reserve_size, false);
+	if (heap->base == nullptr)
+	{
+		LOG_CAT_ERROR(MEMORY, "Failed to reserve %llu bytes for the %s heap.", reserve_size, name);
+		return false;
+	}
+
+	if (!commit_memory(heap->base, HEAP_COMMIT_GRANULARITY))
+	{
+		LOG_CAT_ERROR(MEMORY, "Failed to commit %llu bytes for the %s heap.", (u64)HEAP_COMMIT_GRANULARITY, name);
+		release_memory(heap->base, reserve_size);
+		heap->base = nullptr;
+		return false;
+	}
+
+	heap->reserved_size = reserve_size;
+	heap->committed_size = HEAP_COMMIT_GRANULARITY;
+	heap->name = name;
+
+	// One free block spanning the first commit, then the sentinel.
+	HeapBlock* block = (HeapBlock*)heap->base;
+	block->prev_physical = nullptr;
+	block->size = HEAP_COMMIT_GRANULARITY - 2 * HEAP_BLOCK_HEADER_SIZE;
+
+	heap->sentinel = get_next_block(block);
+	heap->sentinel->prev_physical = block;
+	heap->sentinel->size = 0;
+
+	release_block(heap, block);
+	return true;
+}
+
+void destroy_heap(Heap* heap)
+{
+	if (heap->base != nullptr)
+	{
+		if (heap->allocation_count > 0)
+		{
+			LOG_CAT_WARN(MEMORY, "The %s heap was destroyed with %u live allocations (%llu bytes).", heap->name, heap->allocation_count, heap->used);
+		}
+		release_memory(heap->base, heap->reserved_size);
+	}
+	clear_heap(heap);
+}
+
+void* allocate_from_heap(Heap* heap, u64 size, MemorySiteId site, u64 alignment)
+{
+	Assert((alignment & (alignment - 1)) == 0);
+	if (size >= (1ull << HEAP_FIRST_LEVEL_MAX_BITS))
+	{
+		LOG_CAT_ERROR(MEMORY, "Allocation of %llu bytes is too large for the %s heap.", size, heap->name);
+		return nullptr;
+	}
+
+	size = align_up(size > HEAP_MIN_PAYLOAD_SIZE ? size : HEAP_MIN_PAYLOAD_SIZE, HEAP_DEFAULT_ALIGNMENT);
+
+	// Over-aligned requests leave room to split a free block off the front.
+	u64 search_size = size;
+	if (alignment > HEAP_DEFAULT_ALIGNMENT)
+	{
+		search_size += alignment + HEAP_MIN_BLOCK_SIZE;
+	}
+	search_size = round_up_to_size_class(search_size);
+
+	lock_heap(heap);
+
+	HeapBlock* block = find_free_block(heap, search_size);
+	if (block == nullptr && grow_heap(heap, search_size))
+	{
+		block = find_free_block(heap, search_size);
+	}
+	if (block == nullptr)
+	{
+		unlock_heap(heap);
+		LOG_CAT_ERROR(MEMORY, "The %s heap is out of space, %llu of %llu bytes used.", heap->name, heap->used, heap->reserved_size);
+		return nullptr;
+	}
+	remove_free_block(heap, block);
+
+	if (alignment > HEAP_DEFAULT_ALIGNMENT)
+	{
+		u64 payload = (u64)get_block_payload(block);
+		u64 aligned = align_up(payload, alignment);
+		// The gap becomes a free block, so it must fit a whole one.
+		if (aligned != payload && aligned - payload < HEAP_MIN_BLOCK_SIZE)
+		{
+			aligned = align_up(payload + HEAP_MIN_BLOCK_SIZE, alignment);
+		}
+
+		u64 gap = aligned - payload;
+		if (gap > 0)
+		{
+			HeapBlock* aligned_block = get_payload_block((void*)aligned);
+			aligned_block->prev_physical = block;
+			aligned_block->size = get_block_size(block) - gap;
+			get_next_block(aligned_block)->prev_physical = aligned_block;
+
+			// The block before was not free, or it would have merged with this one.
+			block->size = (gap - HEAP_BLOCK_HEADER_SIZE) | HEAP_BLOCK_FREE;
+			insert_free_block(heap, block);
+			block = aligned_block;
+		}
+	}
+
+	trim_block(heap, block, size);
+	u64 block_size = get_block_size(block);
+	block->size = block_size | ((u64)site << HEAP_BLOCK_SITE_SHIFT);
+
+	heap->used += block_size + HEAP_BLOCK_HEADER_SIZE;
+	heap->allocation_count++;
+	if (heap->used > heap->high_water)
+	{
+		heap->high_water = heap->used;
+	}
+
+	unlock_heap(heap);
+	track_memory(site, (s64)(block_size + HEAP_BLOCK_HEADER_SIZE), 1);
+	return get_block_payload(block);
+}
+
+void free_to_heap(Heap* heap, void* ptr)
+{
+	if (ptr == nullptr)
+	{
+		return;
+	}
+
+	HeapBlock* block = get_payload_block(ptr);
+	Assert((u8*)block >= heap->base && (u8*)block < heap->base + heap->committed_size);
+	Assert(!is_block_free(block));
+
+	MemorySiteId site = (MemorySiteId)(block->size >> HEAP_BLOCK_SITE_SHIFT);
+	u64 block_size = get_block_size(block);
+
+	lock_heap(heap);
+	heap->used -= block_size + HEAP_BLOCK_HEADER_SIZE;
+	heap->allocation_count--;
+	block->size = block_size;
+	release_block(heap, block);
+	unlock_heap(heap);
+
+	track_memory(site, -(s64)(block_size + HEAP_BLOCK_HEADER_SIZE), -1);
+}
+
+u64 get_heap_allocation_size(const void* ptr)
+{
+	return get_block_size(get_payload_block(ptr));
+}
+
+bool initialize_heaps()
+{
+	for (u8 i = 0; i < (u8)HeapId::HEAP_ID_MAX; ++i)
+	{
+		if (!create_heap(&heaps.heaps[i], heap_names[i], heap_reserve_sizes[i]))
+		{
+			shutdown_heaps();
+			return false;
+		}
+	}
+	return true;
+}
+
+void shutdown_heaps(bool release_logging_heap)
+{
+	for (u8 i = 0; i < (u8)HeapId::HEAP_ID_MAX; ++i)
+	{
+		if (i == (u8)HeapId::HEAP_ID_LOGGING && !release_logging_heap)
+		{
+			continue;
+		}
+		destroy_heap(&heaps.heaps[i]);
+	}
+}
+
+Heap* get_heap(HeapId id)
+{
+	return &heaps.heaps[(u8)id];
+}
+
+const char* get_heap_name(HeapId id)
+{
+	return heap_names[(u8)id];
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "core/core_types.h"
+#include "core/memory_tracking.h"
+
+#include <atomic>
+
+// A two-level segregated fit allocator over a virtual memory reservation. Free
+// blocks are kept in size classes, a power of two range split into
+// HEAP_SECOND_LEVEL_COUNT linear steps, and two bitmaps find the first non-empty
+// class that fits. Allocation and free are O(1) and neighbouring free blocks
+// are merged immediately, so fragmentation stays bounded by the class spacing.
+#define HEAP_SECOND_LEVEL_BITS 5
+#define HEAP_SECOND_LEVEL_COUNT (1 << HEAP_SECOND_LEVEL_BITS)
+#define HEAP_ALIGNMENT_BITS 4
+#define HEAP_DEFAULT_ALIGNMENT (1 << HEAP_ALIGNMENT_BITS)
+// Sizes below this use the first level's linear classes, 16 bytes apart.
+#define HEAP_SMALL_BLOCK_SIZE (1 << (HEAP_SECOND_LEVEL_BITS + HEAP_ALIGNMENT_BITS))
+// Largest block is 2^HEAP_FIRST_LEVEL_MAX_BITS - 1 bytes.
+#define HEAP_FIRST_LEVEL_MAX_BITS 40
+#define HEAP_FIRST_LEVEL_COUNT (HEAP_FIRST_LEVEL_MAX_BITS - (HEAP_SECOND_LEVEL_BITS + HEAP_ALIGNMENT_BITS) + 1)
+#define HEAP_COMMIT_GRANULARITY (1024 * 1024)
+
+struct HeapBlock;
+
+struct Heap
+{
+	u8* base;
+	u64 reserved_size;
+	u64 committed_size;
+	u64 used;       // Bytes handed out, including block headers.
+	u64 high_water;
+	u32 allocation_count;
+	const char* name;
+
+	// Last block of the committed range, always allocated and sized zero. Growing
+	// the heap turns it into a free block and writes a new one at the end.
+	HeapBlock* sentinel;
+
+	u32 first_level_bitmap;
+	u32 second_level_bitmaps[HEAP_FIRST_LEVEL_COUNT];
+	HeapBlock* free_lists[HEAP_FIRST_LEVEL_COUNT][HEAP_SECOND_LEVEL_COUNT];
+
+	// Allocations are short, a spin lock keeps them free of syscalls.
+	std::atomic<bool> locked;
+};
+
+bool create_heap(Heap* heap, const char* name, u64 reserve_size);
+void destroy_heap(Heap* heap);
+
+// Returns nullptr once the reservation is exhausted. Memory is not cleared. The
+// block is counted against site until it's freed, pass MEMORY_SITE(tag).
+void* allocate_from_heap(Heap* heap, u64 size, MemorySiteId site, u64 alignment = HEAP_DEFAULT_ALIGNMENT);
+// ptr may be nullptr.
+void free_to_heap(Heap* heap, void* ptr);
+// Usable bytes at ptr, at least the size that was asked for.
+u64 get_heap_allocation_size(const void* ptr);
+
+template <typename T>
+T* allocate_heap_array(Heap* heap, u64 count, MemorySiteId site)
+{
+	return (T*)allocate_from_heap(heap, sizeof(T) * count, site, alignof(T) > HEAP_DEFAULT_ALIGNMENT ? alignof(T) : HEAP_DEFAULT_ALIGNMENT);
+}
+
+// Each engine subsystem allocates from its own heap so one can't fragment
+// another and each heap's usage can be read on its own.
+enum class HeapId : u8
+{
+	HEAP_ID_RENDERER,
+	HEAP_ID_ASSETS,
+	HEAP_ID_LOGGING,
+	HEAP_ID_MAX
+};
+
+// Must run before initialize_logging, the logger allocates from its heap.
+bool initialize_heaps();
+// Pass false when shutdown_logging failed, the logging heap is then left to the OS.
+void shutdown_heaps(bool release_logging_heap = true);
+Heap* get_heap(HeapId id);
+const char* get_heap_name(HeapId id);
\ No newline at end of file
@@ -1,40 +1,203 @@
 #include "core/input.h"
+#include "core/frame_arena.h"
+#include "core/input_recording.h"
+#include "core/intrinsics.h"
 #include "core/logger.h"
 #include "core/platform/platform.h"
 
-struct KeyboardInput
-{
-	bool keys[256];
-};
+#include <atomic>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define INPUT_SSE2 1
+#elif defined(_M_ARM64) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define INPUT_NEON 1
+#endif
 
 struct MouseInput
 {
 	s32 x;
 	s32 y;
-	bool buttons[(u8)Button::BUTTON_MAX_BUTTONS];
+	u8 buttons; // One bit per Button.
+};
+
+// Must be a power of two.
+#define INPUT_EVENT_QUEUE_CAPACITY 1024
+
+// Single-producer/single-consumer ring. The platform layer pushes at head and
+// update_input pops at tail.
+struct InputEventQueue
+{
+	alignas(64) std::atomic<u32> head;
+	alignas(64) std::atomic<u32> tail;
+	std::atomic<u32> dropped_count;
+	InputEvent events[INPUT_EVENT_QUEUE_CAPACITY];
 };
 
 struct Input
 {
-	KeyboardInput keyboard_current;
-	KeyboardInput keyboard_previous;
+	// State built from the events applied by update_input.
+	KeyMask keyboard_current;
+	KeyMask keyboard_previous;
+	KeyMask keys_pressed;
+	KeyMask keys_released;
 	MouseInput mouse_current;
 	MouseInput mouse_previous;
+	u8 buttons_pressed;
+	u8 buttons_released;
+
+	// Per-frame motion, reset by update_input.
+	s32 mouse_delta_x;
+	s32 mouse_delta_y;
+	s32 wheel_delta;
+	// Once raw motion has been seen absolute moves no longer contribute to the delta.
+	bool has_raw_mouse_delta;
+	bool has_mouse_position;
+
+	// From the frame arena, valid until the next update_input.
+	InputEvent* frame_events;
+	u32 frame_event_count;
+	u32 frame;
 };
 
 // TODO: Maybe these shouldn't be globals??
 static bool initialized = false;
 static Input input = {};
+static InputEventQueue event_queue;
+
+static void push_event(InputEventType type, u8 code, bool pressed, s32 x, s32 y)
+{
+	u32 head = event_queue.head.load(std::memory_order_relaxed);
+	u32 tail = event_queue.tail.load(std::memory_order_acquire);
+	if (head - tail >= INPUT_EVENT_QUEUE_CAPACITY)
+	{
+		event_queue.dropped_count.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	InputEvent* event = &event_queue.events[head & (INPUT_EVENT_QUEUE_CAPACITY - 1)];
+	event->timestamp = read_timestamp();
+	event->type = type;
+	event->code = code;
+	event->pressed = pressed;
+	event->x = x;
+	event->y = y;
+
+	event_queue.head.store(head + 1, std::memory_order_release);
+}
+
+static void set_key(KeyMask* mask, u32 code, bool pressed)
+{
+	u64 bit = 1ull << (code & 63);
+	if (pressed)
+	{
+		mask->bits[code >> 6] |= bit;
+	}
+	else
+	{
+		mask->bits[code >> 6] &= ~bit;
+	}
+}
+
+static void apply_event(const InputEvent* event)
+{
+	switch (event->type)
+	{
+	case InputEventType::INPUT_EVENT_KEY:
+	{
+		set_key(&input.keyboard_current, event->code, event->pressed);
+		break;
+	}
+	case InputEventType::INPUT_EVENT_BUTTON:
+	{
+		u8 bit = (u8)(1 << event->code);
+		input.mouse_current.buttons = event->pressed ? (input.mouse_current.buttons | bit) : (input.mouse_current.buttons & ~bit);
+		break;
+	}
+	case InputEventType::INPUT_EVENT_MOUSE_MOVE:
+	{
+		// The first position only sets where the cursor starts.
+		if (!input.has_raw_mouse_delta && input.has_mouse_position)
+		{
+			input.mouse_delta_x += event->x - input.mouse_current.x;
+			input.mouse_delta_y += event->y - input.mouse_current.y;
+		}
+		input.has_mouse_position = true;
+		input.mouse_current.x = event->x;
+		input.mouse_current.y = event->y;
+		break;
+	}
+	case InputEventType::INPUT_EVENT_MOUSE_WHEEL:
+	{
+		input.wheel_delta += event->x;
+		break;
+	}
+	case InputEventType::INPUT_EVENT_MOUSE_DELTA:
+	{
+		if (!input.has_raw_mouse_delta)
+		{
+			// Drop what absolute moves added this frame so motion isn't counted twice.
+			input.has_raw_mouse_delta = true;
+			input.mouse_delta_x = 0;
+			input.mouse_delta_y = 0;
+		}
+		input.mouse_delta_x += event->x;
+		input.mouse_delta_y += event->y;
+		break;
+	}
+	}
+}
+
+static inline bool test_key(const KeyMask& mask, Key key)
+{
+	u32 code = (u32)key;
+	return (mask.bits[(code >> 6) & 3] >> (code & 63)) & 1;
+}
+
+static inline bool test_button(u8 buttons, Button button)
+{
+	return (buttons >> (u8)button) & 1;
+}
+
+// pressed = current & ~previous, released = previous & ~current.
+static void compute_key_edges(const KeyMask* current, const KeyMask* previous, KeyMask* pressed, KeyMask* released)
+{
+#if INPUT_SSE2
+	for (u32 i = 0; i < 4; i += 2)
+	{
+		__m128i now = _mm_loadu_si128((const __m128i*)&current->bits[i]);
+		__m128i before = _mm_loadu_si128((const __m128i*)&previous->bits[i]);
+		_mm_storeu_si128((__m128i*)&pressed->bits[i], _mm_andnot_si128(before, now));
+		_mm_storeu_si128((__m128i*)&released->bits[i], _mm_andnot_si128(now, before));
+	}
+#elif INPUT_NEON
+	for (u32 i = 0; i < 4; i += 2)
+	{
+		uint64x2_t now = vld1q_u64(&current->bits[i]);
+		uint64x2_t before = vld1q_u64(&previous->bits[i]);
+		vst1q_u64(&pressed->bits[i], vbicq_u64(now, before));
+		vst1q_u64(&released->bits[i], vbicq_u64(before, now));
+	}
+#else
+	for (u32 i = 0; i < 4; ++i)
+	{
+		pressed->bits[i] = current->bits[i] & ~previous->bits[i];
+		released->bits[i] = previous->bits[i] & ~current->bits[i];
+	}
+#endif
+}
 
 void initialize_input()
 {
 	initialized = true;
-	LOG_INFO("Input subsystem initialized.");
+	LOG_CAT_INFO(INPUT, "Input subsystem initialized.");
 }
 
 void shutdown_input()
 {
-	// TODO: Add shutdown routines when needed.
+	stop_input_recording();
+	stop_input_replay();
 	initialized = false;
 }
 
@@ -42,66 +205,181 @@ void update_input(f64 delta_time)
 {
 	Assert(initialized);
 
-	copy_memory(&input.keyboard_previous, &input.keyboard_current, sizeof(KeyboardInput));
-	copy_memory(&input.mouse_previous, &input.mouse_current, sizeof(MouseInput));
+	input.keyboard_previous = input.keyboard_current;
+	input.mouse_previous = input.mouse_current;
+	input.mouse_delta_x = 0;
+	input.mouse_delta_y = 0;
+	input.wheel_delta = 0;
+
+	// Only drain what was queued when we started, so a busy producer can't stall the frame.
+	u32 tail = event_queue.tail.load(std::memory_order_relaxed);
+	u32 head = event_queue.head.load(std::memory_order_acquire);
+	bool replaying = is_input_replaying();
+	u32 capacity = replaying ? INPUT_EVENT_QUEUE_CAPACITY : head - tail;
+	input.frame_events = allocate_frame_array<InputEvent>(capacity);
+	if (input.frame_events == nullptr)
+	{
+		// Whatever doesn't fit waits in the queue for the next frame.
+		capacity = 0;
+	}
+	input.frame_event_count = 0;
+	if (replaying)
+	{
+		// Live events are thrown away so the frame only sees the recording.
+		tail = head;
+		input.frame_event_count = read_replay_events(input.frame_events, capacity);
+		for (u32 i = 0; i < input.frame_event_count; ++i)
+		{
+			apply_event(&input.frame_events[i]);
+		}
+	}
+	for (; tail != head && input.frame_event_count < capacity; ++tail)
+	{
+		InputEvent* event = &input.frame_events[input.frame_event_count++];
+		*event = event_queue.events[tail & (INPUT_EVENT_QUEUE_CAPACITY - 1)];
+		apply_event(event);
+	}
+	event_queue.tail.store(tail, std::memory_order_release);
+
+	input.frame++;
+	for (u32 i = 0; i < input.frame_event_count; ++i)
+	{
+		input.frame_events[i].frame = input.frame;
+	}
+	record_input_events(input.frame_events, input.frame_event_count);
+
+	u32 dropped = event_queue.dropped_count.exchange(0, std::memory_order_relaxed);
+	if (dropped > 0)
+	{
+		LOG_CAT_WARN(INPUT, "Input event queue full, dropped %u events.", dropped);
+	}
+
+	compute_key_edges(&input.keyboard_current, &input.keyboard_previous, &input.keys_pressed, &input.keys_released);
+	input.buttons_pressed = input.mouse_current.buttons & ~input.mouse_previous.buttons;
+	input.buttons_released = input.mouse_previous.buttons & ~input.mouse_current.buttons;
 }
 
 // Keyboard input.
 bool is_key_down(Key key)
 {
 	Assert(initialized);
-	return input.keyboard_current.keys[(u32)key] == true;
+	return test_key(input.keyboard_current, key);
 }
+
 bool is_key_up(Key key)
 {
 	Assert(initialized);
-	return input.keyboard_current.keys[(u32)key] == false;
+	return !test_key(input.keyboard_current, key);
 }
 
 bool was_key_down(Key key)
 {
 	Assert(initialized);
-	return input.keyboard_previous.keys[(u32)key] == true;
+	return test_key(input.keyboard_previous, key);
 }
 
 bool was_key_up(Key key)
 {
 	Assert(initialized);
-	return input.keyboard_previous.keys[(u32)key] == false;
+	return !test_key(input.keyboard_previous, key);
+}
+
+bool was_key_pressed(Key key)
+{
+	Assert(initialized);
+	return test_key(input.keys_pressed, key);
+}
+
+bool was_key_released(Key key)
+{
+	Assert(initialized);
+	return test_key(input.keys_released, key);
+}
+
+u32 get_changed_keys(Key* keys, u32 max_keys)
+{
+	Assert(initialized);
+
+	u32 count = 0;
+	for (u32 i = 0; i < 4; ++i)
+	{
+		u64 changed = input.keys_pressed.bits[i] | input.keys_released.bits[i];
+		while (changed != 0 && count < max_keys)
+		{
+			keys[count++] = (Key)((i << 6) + count_trailing_zeros_u64(changed));
+			changed &= changed - 1;
+		}
+	}
+	return count;
+}
+
+const InputEvent* get_input_events(u32* count)
+{
+	Assert(initialized);
+	*count = input.frame_event_count;
+	return input.frame_events;
+}
+
+u32 get_input_frame()
+{
+	Assert(initialized);
+	return input.frame;
+}
+
+void get_key_masks(KeyMask* down, KeyMask* pressed, KeyMask* released)
+{
+	Assert(initialized);
+	if (down) *down = input.keyboard_current;
+	if (pressed) *pressed = input.keys_pressed;
+	if (released) *released = input.keys_released;
 }
 
 void process_key(Key key, bool pressed)
 {
 	// LOG_DEBUG("Processing key: %c", (u16)key);
-	if (input.keyboard_current.keys[(u32)key] != pressed)
+	if ((u32)key >= 256)
 	{
-		input.keyboard_current.keys[(u32)key] = pressed;
+		return;
 	}
+
+	push_event(InputEventType::INPUT_EVENT_KEY, (u8)key, pressed, 0, 0);
 }
 
 // Mouse input.
 bool is_button_down(Button button)
 {
 	Assert(initialized);
-	return input.mouse_current.buttons[(u8)button] == true;
+	return test_button(input.mouse_current.buttons, button);
 }
 
 bool is_button_up(Button button)
 {
 	Assert(initialized);
-	return input.mouse_current.buttons[(u8)button] == false;
+	return !test_button(input.mouse_current.buttons, button);
 }
 
 bool was_button_down(Button button)
 {
 	Assert(initialized);
-	return input.mouse_previous.buttons[(u8)button] == true;
+	return test_button(input.mouse_previous.buttons, button);
 }
 
 bool was_button_up(Button button)
 {
 	Assert(initialized);
-	return input.mouse_previous.buttons[(u8)button] == false;
+	return !test_button(input.mouse_previous.buttons, button);
+}
+
+bool was_button_pressed(Button button)
+{
+	Assert(initialized);
+	return test_button(input.buttons_pressed, button);
+}
+
+bool was_button_released(Button button)
+{
+	Assert(initialized);
+	return test_button(input.buttons_released, button);
 }
 
 void get_mouse_position(s32& x, s32& y)
@@ -118,27 +396,46 @@ void get_previous_mouse_position(s32& x, s32& y)
 	y = input.mouse_previous.y;
 }
 
+void get_button_masks(u8* down, u8* pressed, u8* released)
+{
+	Assert(initialized);
+	if (down) *down = input.mouse_current.buttons;
+	if (pressed) *pressed = input.buttons_pressed;
+	if (released) *released = input.buttons_released;
+}
+
+void get_mouse_delta(s32& x, s32& y)
+{
+	Assert(initialized);
+	x = input.mouse_delta_x;
+	y = input.mouse_delta_y;
+}
+
+s32 get_mouse_wheel_delta()
+{
+	Assert(initialized);
+	return input.wheel_delta;
+}
+
 void process_button(Button button, bool pressed)
 {
 	// LOG_DEBUG("Processing Button: %d", (u8)button);
-	if (input.mouse_current.buttons[(u8)button] != pressed)
-	{
-		input.mouse_current.buttons[(u8)button] = pressed;
-	}
+	push_event(InputEventType::INPUT_EVENT_BUTTON, (u8)button, pressed, 0, 0);
 }
 
 void process_mouse_move(s32 x, s32 y)
 {
-	if (input.mouse_current.x != x || input.mouse_current.y != y)
-	{
-		// LOG_DEBUG("Processing mouse movement: %d, %d", x, y);
-		input.mouse_current.x = x;
-		input.mouse_current.y = y;
-	}
+	// LOG_DEBUG("Processing mouse movement: %d, %d", x, y);
+	push_event(InputEventType::INPUT_EVENT_MOUSE_MOVE, 0, false, x, y);
 }
 
-void process_mouse_wheel(s8 z_delta)
+void process_mouse_wheel(s32 z_delta)
 {
-	// TODO: Add this to input tracking.
 	// LOG_DEBUG("Processing mouse scroll: %d", z_delta);
+	push_event(InputEventType::INPUT_EVENT_MOUSE_WHEEL, 0, false, z_delta, 0);
+}
+
+void process_mouse_delta(s32 x_delta, s32 y_delta)
+{
+	push_event(InputEventType::INPUT_EVENT_MOUSE_DELTA, 0, false, x_delta, y_delta);
 }
\ No newline at end of file
@@ -148,15 +148,64 @@ enum class Key : u32
     KEYS_MAX_KEYS
 };
 
+// One bit per key code, bit (code & 63) of bits[code >> 6].
+struct KeyMask
+{
+	u64 bits[4];
+};
+
+enum class InputEventType : u8
+{
+	INPUT_EVENT_KEY,
+	INPUT_EVENT_BUTTON,
+	INPUT_EVENT_MOUSE_MOVE,
+	INPUT_EVENT_MOUSE_WHEEL,
+	INPUT_EVENT_MOUSE_DELTA
+};
+
+// Wheel deltas are in the same units as Win32, one notch is 120.
+#define MOUSE_WHEEL_NOTCH 120
+
+struct InputEvent
+{
+	u64 timestamp; // read_timestamp() when the event was processed.
+	u32 frame;     // The update_input frame that consumed the event.
+	InputEventType type;
+	u8 code;       // Key or Button.
+	bool pressed;
+	s32 x;         // Mouse position, relative motion, or the wheel delta in x.
+	s32 y;
+};
+
 void initialize_input();
 void shutdown_input();
+// The process_* functions push timestamped events onto a single-producer/
+// single-consumer queue, so they may run on a different thread (the window
+// thread) than the one calling update_input and the queries (the game thread).
+//
+// update_input drains the queue, applies the events in order and computes which
+// keys and buttons were pressed or released. Call it once per frame.
 void update_input(f64 delta_time);
 
+// Events applied by the last update_input, in the order they arrived. They live
+// in the frame arena, so they are only valid for the current frame.
+const InputEvent* get_input_events(u32* count);
+// Number of update_input calls so far, the frame the last one stamped on its events.
+u32 get_input_frame();
+
 // Keyboard input.
 bool is_key_down(Key key);
 bool is_key_up(Key key);
 bool was_key_down(Key key);
 bool was_key_up(Key key);
+// True only on the frame the key went down or up.
+bool was_key_pressed(Key key);
+bool was_key_released(Key key);
+
+// Writes up to max_keys keys that were pressed or released this frame and
+// returns how many were written.
+u32 get_changed_keys(Key* keys, u32 max_keys);
+void get_key_masks(KeyMask* down, KeyMask* pressed, KeyMask* released);
 
 void process_key(Key key, bool pressed);
 
@@ -165,9 +214,22 @@ bool is_button_down(Button button);
 bool is_button_up(Button button);
 bool was_button_down(Button button);
 bool was_button_up(Button button);
+bool was_button_pressed(Button button);
+bool was_button_released(Button button);
 void get_mouse_position(s32& x, s32& y);
 void get_previous_mouse_position(s32& x, s32& y);
+// One bit per Button.
+void get_button_masks(u8* down, u8* pressed, u8* released);
+// Motion accumulated over every event applied by the last update_input, so
+// nothing between frames is lost. Uses raw device motion when the platform
+// provides it (not clamped to the window or screen edges), otherwise the
+// change in absolute position.
+void get_mouse_delta(s32& x, s32& y);
+// Sum of the wheel deltas applied by the last update_input.
+s32 get_mouse_wheel_delta();
 
 void process_button(Button button, bool pressed);
 void process_mouse_move(s32 x, s32 y);
-void process_mouse_wheel(s8 z_delta);
\ No newline at end of file
+void process_mouse_wheel(s32 z_delta);
+// Relative motion straight from the device, in device units.
+void process_mouse_delta(s32 x_delta, s32 y_delta);
\ No newline at end of file
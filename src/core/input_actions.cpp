@@ -0,0 +1,333 @@
+#include "core/input_actions.h"
+#include "core/logger.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct ActionMask
+{
+	KeyMask keys;
+	u8 buttons;
+};
+
+struct ActionMaskTable
+{
+	ActionMask actions[(u32)Action::ACTION_MAX_ACTIONS];
+};
+
+static constexpr ActionBinding default_bindings[] =
+{
+	{ Action::ACTION_MOVE_FORWARD,  BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_W },
+	{ Action::ACTION_MOVE_FORWARD,  BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_UP },
+	{ Action::ACTION_MOVE_BACKWARD, BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_S },
+	{ Action::ACTION_MOVE_BACKWARD, BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_DOWN },
+	{ Action::ACTION_MOVE_LEFT,     BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_A },
+	{ Action::ACTION_MOVE_LEFT,     BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_LEFT },
+	{ Action::ACTION_MOVE_RIGHT,    BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_D },
+	{ Action::ACTION_MOVE_RIGHT,    BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_RIGHT },
+	{ Action::ACTION_MOVE_UP,       BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_SPACE },
+	{ Action::ACTION_MOVE_DOWN,     BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_CONTROL },
+	{ Action::ACTION_SPRINT,        BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_SHIFT },
+	{ Action::ACTION_LOOK,          BindingDevice::BINDING_DEVICE_BUTTON, (u8)Button::BUTTON_RIGHT },
+};
+
+static constexpr u32 DEFAULT_BINDING_COUNT = sizeof(default_bindings) / sizeof(default_bindings[0]);
+
+// Must match the order of Action.
+static const char* action_names[(u32)Action::ACTION_MAX_ACTIONS] =
+{
+	"move_forward",
+	"move_backward",
+	"move_left",
+	"move_right",
+	"move_up",
+	"move_down",
+	"sprint",
+	"look",
+};
+
+static constexpr ActionMaskTable build_action_masks(const ActionBinding* bindings, u32 count)
+{
+	ActionMaskTable table = {};
+	for (u32 i = 0; i < count; ++i)
+	{
+		ActionMask& mask = table.actions[(u32)bindings[i].action];
+		u32 code = bindings[i].code;
+		if (bindings[i].device == BindingDevice::BINDING_DEVICE_KEY)
+		{
+			mask.keys.bits[code >> 6] |= 1ull << (code & 63);
+		}
+		else
+		{
+			mask.buttons |= (u8)(1 << code);
+		}
+	}
+	return table;
+}
+
+// The defaults are baked into the executable, rebinding only ever swaps the runtime copy.
+static constexpr ActionMaskTable default_masks = build_action_masks(default_bindings, DEFAULT_BINDING_COUNT);
+
+struct Actions
+{
+	ActionMaskTable masks;
+	u32 current;
+	u32 previous;
+};
+
+static bool initialized = false;
+static Actions actions = {};
+
+void initialize_actions()
+{
+	actions.masks = default_masks;
+	actions.current = 0;
+	actions.previous = 0;
+	initialized = true;
+}
+
+void update_actions()
+{
+	Assert(initialized);
+
+	KeyMask keys;
+	u8 buttons;
+	get_key_masks(&keys, nullptr, nullptr);
+	get_button_masks(&buttons, nullptr, nullptr);
+
+	u32 states = 0;
+	for (u32 i = 0; i < (u32)Action::ACTION_MAX_ACTIONS; ++i)
+	{
+		const ActionMask* mask = &actions.masks.actions[i];
+		u64 hit = (mask->keys.bits[0] & keys.bits[0]) | (mask->keys.bits[1] & keys.bits[1]) |
+			(mask->keys.bits[2] & keys.bits[2]) | (mask->keys.bits[3] & keys.bits[3]) |
+			(u64)(mask->buttons & buttons);
+		states |= (u32)(hit != 0) << i;
+	}
+
+	actions.previous = actions.current;
+	actions.current = states;
+}
+
+bool is_action_down(Action action)
+{
+	Assert(initialized);
+	return (actions.current >> (u32)action) & 1;
+}
+
+bool was_action_pressed(Action action)
+{
+	Assert(initialized);
+	return ((actions.current & ~actions.previous) >> (u32)action) & 1;
+}
+
+bool was_action_released(Action action)
+{
+	Assert(initialized);
+	return ((actions.previous & ~actions.current) >> (u32)action) & 1;
+}
+
+u32 get_action_states()
+{
+	Assert(initialized);
+	return actions.current;
+}
+
+const char* get_action_name(Action action)
+{
+	return action_names[(u32)action];
+}
+
+void set_action_bindings(const ActionBinding* bindings, u32 count)
+{
+	actions.masks = build_action_masks(bindings, count);
+}
+
+void reset_action_bindings()
+{
+	actions.masks = default_masks;
+}
+
+struct KeyName
+{
+	const char* name;
+	BindingDevice device;
+	u8 code;
+};
+
+static const KeyName key_names[] =
+{
+	{ "BACKSPACE",    BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_BACKSPACE },
+	{ "TAB",          BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_TAB },
+	{ "ENTER",        BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_ENTER },
+	{ "SHIFT",        BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_SHIFT },
+	{ "CONTROL",      BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_CONTROL },
+	{ "PAUSE",        BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_PAUSE },
+	{ "CAPSLOCK",     BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_CAPITAL },
+	{ "ESCAPE",       BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_ESCAPE },
+	{ "SPACE",        BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_SPACE },
+	{ "PAGEUP",       BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_PRIOR },
+	{ "PAGEDOWN",     BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_NEXT },
+	{ "END",          BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_END },
+	{ "HOME",         BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_HOME },
+	{ "LEFT",         BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_LEFT },
+	{ "UP",           BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_UP },
+	{ "RIGHT",        BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_RIGHT },
+	{ "DOWN",         BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_DOWN },
+	{ "INSERT",       BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_INSERT },
+	{ "DELETE",       BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_DELETE },
+	{ "NUMPAD0",      BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_NUMPAD0 },
+	{ "NUMPAD1",      BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_NUMPAD1 },
+	{ "NUMPAD2",      BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_NUMPAD2 },
+	{ "NUMPAD3",      BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_NUMPAD3 },
+	{ "NUMPAD4",      BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_NUMPAD4 },
+	{ "NUMPAD5",      BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_NUMPAD5 },
+	{ "NUMPAD6",      BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_NUMPAD6 },
+	{ "NUMPAD7",      BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_NUMPAD7 },
+	{ "NUMPAD8",      BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_NUMPAD8 },
+	{ "NUMPAD9",      BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_NUMPAD9 },
+	{ "LSHIFT",       BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_LSHIFT },
+	{ "RSHIFT",       BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_RSHIFT },
+	{ "LCONTROL",     BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_LCONTROL },
+	{ "RCONTROL",     BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_RCONTROL },
+	{ "LALT",         BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_LMENU },
+	{ "RALT",         BindingDevice::BINDING_DEVICE_KEY,    (u8)Key::KEY_RMENU },
+	{ "MOUSE_LEFT",   BindingDevice::BINDING_DEVICE_BUTTON, (u8)Button::BUTTON_LEFT },
+	{ "MOUSE_RIGHT",  BindingDevice::BINDING_DEVICE_BUTTON, (u8)Button::BUTTON_RIGHT },
+	{ "MOUSE_MIDDLE", BindingDevice::BINDING_DEVICE_BUTTON, (u8)Button::BUTTON_MIDDLE },
+};
+
+static bool equals_ignore_case(const char* a, const char* b)
+{
+	for (; *a && *b; ++a, ++b)
+	{
+		if (toupper((u8)*a) != toupper((u8)*b))
+		{
+			return false;
+		}
+	}
+	return *a == *b;
+}
+
+static bool parse_key_name(const char* name, BindingDevice* device, u8* code)
+{
+	// Letters and digits use their character code, the same as Win32 virtual keys.
+	if (name[0] != '\0' && name[1] == '\0' && isalnum((u8)name[0]))
+	{
+		*device = BindingDevice::BINDING_DEVICE_KEY;
+		*code = (u8)toupper((u8)name[0]);
+		return true;
+	}
+
+	if (toupper((u8)name[0]) == 'F' && isdigit((u8)name[1]))
+	{
+		// The whole rest of the name must be the number, so "F1X" isn't taken for F1.
+		char* end;
+		unsigned long number = strtoul(name + 1, &end, 10);
+		if (*end == '\0' && number >= 1 && number <= 24)
+		{
+			*device = BindingDevice::BINDING_DEVICE_KEY;
+			*code = (u8)((u32)Key::KEY_F1 + number - 1);
+			return true;
+		}
+	}
+
+	for (const KeyName& key_name : key_names)
+	{
+		if (equals_ignore_case(name, key_name.name))
+		{
+			*device = key_name.device;
+			*code = key_name.code;
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool parse_action_name(const char* name, Action* action)
+{
+	for (u32 i = 0; i < (u32)Action::ACTION_MAX_ACTIONS; ++i)
+	{
+		if (equals_ignore_case(name, action_names[i]))
+		{
+			*action = (Action)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool load_action_bindings(const char* path)
+{
+	FILE* file = fopen(path, "r");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	ActionBinding bindings[ACTION_MAX_BINDINGS];
+	u32 binding_count = 0;
+	u32 overridden = 0;
+
+	char line[256];
+	u32 line_number = 0;
+	while (fgets(line, sizeof(line), file))
+	{
+		line_number++;
+
+		char* comment = strchr(line, '#');
+		if (comment)
+		{
+			*comment = '\0';
+		}
+
+		char* separator = strchr(line, '=');
+		if (separator == nullptr)
+		{
+			continue;
+		}
+		*separator = '\0';
+
+		char* action_name = strtok(line, " \t\r\n");
+		Action action;
+		if (action_name == nullptr || !parse_action_name(action_name, &action))
+		{
+			LOG_CAT_WARN(INPUT, "%s:%u: Unknown action '%s'.", path, line_number, action_name ? action_name : "");
+			continue;
+		}
+		overridden |= 1u << (u32)action;
+
+		for (char* name = strtok(separator + 1, " \t\r\n,"); name; name = strtok(nullptr, " \t\r\n,"))
+		{
+			ActionBinding binding;
+			binding.action = action;
+			if (!parse_key_name(name, &binding.device, &binding.code))
+			{
+				LOG_CAT_WARN(INPUT, "%s:%u: Unknown key '%s'.", path, line_number, name);
+				continue;
+			}
+			if (binding_count == ACTION_MAX_BINDINGS)
+			{
+				LOG_CAT_WARN(INPUT, "%s:%u: Too many bindings, ignoring '%s'.", path, line_number, name);
+				continue;
+			}
+			bindings[binding_count++] = binding;
+		}
+	}
+	fclose(file);
+
+	// Keep the defaults for anything the file didn't mention.
+	for (u32 i = 0; i < DEFAULT_BINDING_COUNT && binding_count < ACTION_MAX_BINDINGS; ++i)
+	{
+		if (!(overridden & (1u << (u32)default_bindings[i].action)))
+		{
+			bindings[binding_count++] = default_bindings[i];
+		}
+	}
+
+	set_action_bindings(bindings, binding_count);
+	LOG_CAT_INFO(INPUT, "Loaded action bindings from %s.", path);
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "core/core_types.h"
+#include "core/input.h"
+
+// Actions are what gameplay code asks about instead of individual keys. Every
+// action has a key mask and a button mask built from its bindings, so all of
+// them are evaluated against the packed input state in one pass per frame.
+enum class Action : u8
+{
+	ACTION_MOVE_FORWARD,
+	ACTION_MOVE_BACKWARD,
+	ACTION_MOVE_LEFT,
+	ACTION_MOVE_RIGHT,
+	ACTION_MOVE_UP,
+	ACTION_MOVE_DOWN,
+	ACTION_SPRINT,
+	ACTION_LOOK,
+	ACTION_MAX_ACTIONS
+};
+
+static_assert((u32)Action::ACTION_MAX_ACTIONS <= 32, "Action states are stored one bit per action in a u32.");
+
+enum class BindingDevice : u8
+{
+	BINDING_DEVICE_KEY,
+	BINDING_DEVICE_BUTTON
+};
+
+struct ActionBinding
+{
+	Action action;
+	BindingDevice device;
+	u8 code; // Key or Button.
+};
+
+#define ACTION_MAX_BINDINGS 256
+#define ACTION_BINDINGS_DEFAULT_PATH "bindings.cfg"
+
+void initialize_actions();
+// Evaluates every action from the state built by update_input, call it right after.
+void update_actions();
+
+bool is_action_down(Action action);
+bool was_action_pressed(Action action);
+bool was_action_released(Action action);
+// One bit per action, bit (u32)action.
+u32 get_action_states();
+
+const char* get_action_name(Action action);
+
+// Replaces every binding. The masks are rebuilt here, so evaluation costs the same
+// no matter how the actions are bound.
+void set_action_bindings(const ActionBinding* bindings, u32 count);
+void reset_action_bindings();
+
+// Loads bindings from a text file with one action per line:
+//
+//     # Comment
+//     move_forward = W, UP
+//     look = MOUSE_RIGHT
+//
+// Actions listed in the file replace their default bindings, the rest keep them.
+// Letters and digits are their character, other keys use the names in input_actions.cpp.
+bool load_action_bindings(const char* path);
\ No newline at end of file
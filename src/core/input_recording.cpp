@@ -0,0 +1,241 @@
+#include "core/input_recording.h"
+#include "core/logger.h"
+#include "core/platform/platform.h"
+
+#include <stdio.h>
+
+struct InputRecorder
+{
+	FILE* file;
+	u32 frame;
+	u32 event_count;
+};
+
+struct InputReplayer
+{
+	FILE* file;
+	u32 frame;
+	u32 frame_count;
+	u32 events_remaining;
+	bool has_pending;
+	InputRecordingEntry pending;
+	bool finished;
+};
+
+static InputRecorder recorder = {};
+static InputReplayer replayer = {};
+
+bool start_input_recording(const char* path)
+{
+	stop_input_recording();
+
+	recorder.file = fopen(path, "wb");
+	if (recorder.file == nullptr)
+	{
+		LOG_CAT_ERROR(INPUT, "Failed to open input recording %s.", path);
+		return false;
+	}
+
+	// The counts are filled in by stop_input_recording.
+	InputRecordingHeader header = {};
+	header.magic = INPUT_RECORDING_MAGIC;
+	header.version = INPUT_RECORDING_VERSION;
+	fwrite(&header, sizeof(header), 1, recorder.file);
+
+	recorder.frame = 0;
+	recorder.event_count = 0;
+	LOG_CAT_INFO(INPUT, "Recording input to %s.", path);
+	return true;
+}
+
+void stop_input_recording()
+{
+	if (recorder.file == nullptr)
+	{
+		return;
+	}
+
+	InputRecordingHeader header = {};
+	header.magic = INPUT_RECORDING_MAGIC;
+	header.version = INPUT_RECORDING_VERSION;
+	header.frame_count = recorder.frame;
+	header.event_count = recorder.event_count;
+	fseek(recorder.file, 0, SEEK_SET);
+	fwrite(&header, sizeof(header), 1, recorder.file);
+	fclose(recorder.file);
+
+	LOG_CAT_INFO(INPUT, "Recorded %u input events over %u frames.", recorder.event_count, recorder.frame);
+	recorder = {};
+}
+
+bool is_input_recording()
+{
+	return recorder.file != nullptr;
+}
+
+void record_input_events(const InputEvent* events, u32 count)
+{
+	if (recorder.file == nullptr)
+	{
+		return;
+	}
+
+	for (u32 i = 0; i < count; ++i)
+	{
+		InputRecordingEntry entry = {};
+		entry.frame = recorder.frame;
+		entry.type = (u8)events[i].type;
+		entry.code = events[i].code;
+		entry.pressed = events[i].pressed ? 1 : 0;
+		entry.x = events[i].x;
+		entry.y = events[i].y;
+		fwrite(&entry, sizeof(entry), 1, recorder.file);
+	}
+
+	// Keeps the entries on disk if the process dies before stop_input_recording.
+	if (count > 0)
+	{
+		fflush(recorder.file);
+	}
+
+	recorder.event_count += count;
+	recorder.frame++;
+}
+
+static void read_pending_entry()
+{
+	replayer.has_pending = false;
+	if (replayer.events_remaining == 0)
+	{
+		return;
+	}
+
+	if (fread(&replayer.pending, sizeof(replayer.pending), 1, replayer.file) == 1)
+	{
+		// A corrupt entry would hand apply_event a type or button it can't handle,
+		// so the replay stops there.
+		const InputRecordingEntry* entry = &replayer.pending;
+		if (entry->type > (u8)InputEventType::INPUT_EVENT_MOUSE_DELTA ||
+			(entry->type == (u8)InputEventType::INPUT_EVENT_BUTTON && entry->code >= (u8)Button::BUTTON_MAX_BUTTONS))
+		{
+			LOG_CAT_ERROR(INPUT, "Invalid input recording entry (type %u, code %u), stopping the replay with %u events left.", entry->type, entry->code, replayer.events_remaining);
+			replayer.events_remaining = 0;
+			return;
+		}
+
+		replayer.has_pending = true;
+		replayer.events_remaining--;
+	}
+	else
+	{
+		LOG_CAT_WARN(INPUT, "Input recording ended early, %u events missing.", replayer.events_remaining);
+		replayer.events_remaining = 0;
+	}
+}
+
+bool start_input_replay(const char* path)
+{
+	stop_input_replay();
+
+	replayer.file = fopen(path, "rb");
+	if (replayer.file == nullptr)
+	{
+		LOG_CAT_ERROR(INPUT, "Failed to open input recording %s.", path);
+		return false;
+	}
+
+	InputRecordingHeader header;
+	if (fread(&header, sizeof(header), 1, replayer.file) != 1 || header.magic != INPUT_RECORDING_MAGIC || header.version != INPUT_RECORDING_VERSION)
+	{
+		LOG_CAT_ERROR(INPUT, "%s is not an input recording.", path);
+		fclose(replayer.file);
+		replayer = {};
+		return false;
+	}
+
+	// Recordings that were never stopped, usually because of a crash, still have
+	// zero counts. Take them from the entries instead, ending on the last event.
+	if (header.frame_count == 0 && header.event_count == 0)
+	{
+		fseek(replayer.file, 0, SEEK_END);
+		long file_size = ftell(replayer.file);
+		header.event_count = file_size > (long)sizeof(header) ? (u32)((file_size - (long)sizeof(header)) / sizeof(InputRecordingEntry)) : 0;
+
+		InputRecordingEntry last = {};
+		if (header.event_count > 0)
+		{
+			fseek(replayer.file, (long)sizeof(header) + (long)(header.event_count - 1) * (long)sizeof(InputRecordingEntry), SEEK_SET);
+			if (fread(&last, sizeof(last), 1, replayer.file) == 1)
+			{
+				header.frame_count = last.frame + 1;
+			}
+		}
+		fseek(replayer.file, sizeof(header), SEEK_SET);
+
+		if (header.event_count > 0)
+		{
+			LOG_CAT_WARN(INPUT, "%s was not stopped cleanly, replaying the events it holds.", path);
+		}
+	}
+
+	replayer.frame = 0;
+	replayer.frame_count = header.frame_count;
+	replayer.events_remaining = header.event_count;
+	replayer.finished = false;
+	read_pending_entry();
+
+	LOG_CAT_INFO(INPUT, "Replaying %u input events over %u frames from %s.", header.event_count, header.frame_count, path);
+	return true;
+}
+
+void stop_input_replay()
+{
+	if (replayer.file != nullptr)
+	{
+		fclose(replayer.file);
+	}
+	replayer = {};
+}
+
+bool is_input_replaying()
+{
+	return replayer.file != nullptr;
+}
+
+bool is_input_replay_finished()
+{
+	return replayer.finished;
+}
+
+u32 read_replay_events(InputEvent* events, u32 max_events)
+{
+	if (replayer.file == nullptr || replayer.finished)
+	{
+		return 0;
+	}
+
+	// Entries are in frame order. If more events were recorded for a frame than
+	// fit, the rest spill into the next frame.
+	u64 now = read_timestamp();
+	u32 count = 0;
+	while (replayer.has_pending && replayer.pending.frame <= replayer.frame && count < max_events)
+	{
+		InputEvent* event = &events[count++];
+		event->timestamp = now;
+		event->frame = 0;
+		event->type = (InputEventType)replayer.pending.type;
+		event->code = replayer.pending.code;
+		event->pressed = replayer.pending.pressed != 0;
+		event->x = replayer.pending.x;
+		event->y = replayer.pending.y;
+		read_pending_entry();
+	}
+
+	replayer.frame++;
+	if (replayer.frame >= replayer.frame_count && !replayer.has_pending)
+	{
+		replayer.finished = true;
+	}
+
+	return count;
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "core/core_types.h"
+#include "core/input.h"
+
+// An input recording is every event update_input applied, tagged with the frame
+// it was applied on. Replaying one feeds the same events to the same frames, so
+// a benchmark session can be re-run without anyone at the keyboard.
+#define INPUT_RECORDING_MAGIC 0x43455249 // "IREC"
+#define INPUT_RECORDING_VERSION 2
+
+struct InputRecordingHeader
+{
+	u32 magic;
+	u32 version;
+	// Written when the recording is stopped. While both are zero the replayer
+	// counts the entries instead.
+	u32 frame_count;
+	u32 event_count;
+};
+
+// Timestamps are not stored, replayed events are stamped when they are applied.
+struct InputRecordingEntry
+{
+	u32 frame;
+	u8 type;
+	u8 code;
+	u8 pressed;
+	u8 padding;
+	s32 x;
+	s32 y;
+};
+
+static_assert(sizeof(InputRecordingEntry) == 16, "Expected InputRecordingEntry to be 16 bytes.");
+
+bool start_input_recording(const char* path);
+void stop_input_recording();
+bool is_input_recording();
+
+bool start_input_replay(const char* path);
+void stop_input_replay();
+bool is_input_replaying();
+// True once every frame of the recording has been replayed.
+bool is_input_replay_finished();
+
+// Called by update_input once per frame with the events it applied.
+void record_input_events(const InputEvent* events, u32 count);
+// Called by update_input once per frame instead of draining the live queue.
+// Returns the number of events written to events.
+u32 read_replay_events(InputEvent* events, u32 max_events);
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "core/core_types.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Index of the lowest set bit. value must not be zero.
+inline u32 count_trailing_zeros_u64(u64 value)
+{
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward64(&index, value);
+	return (u32)index;
+#else
+	return (u32)__builtin_ctzll(value);
+#endif
+}
+
+// Index of the highest set bit. value must not be zero.
+inline u32 find_last_set_u64(u64 value)
+{
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanReverse64(&index, value);
+	return (u32)index;
+#else
+	return 63 - (u32)__builtin_clzll(value);
+#endif
+}
+
+inline u32 popcount_u64(u64 value)
+{
+#if defined(_MSC_VER)
+	// __popcnt64 assumes the POPCNT instruction is available, so count in software.
+	value = value - ((value >> 1) & 0x5555555555555555ull);
+	value = (value & 0x3333333333333333ull) + ((value >> 2) & 0x3333333333333333ull);
+	return (u32)((((value + (value >> 4)) & 0x0F0F0F0F0F0F0F0Full) * 0x0101010101010101ull) >> 56);
+#else
+	return (u32)__builtin_popcountll(value);
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,436 @@
+#include "core/jobs.h"
+#include "core/logger.h"
+
+#include <stdio.h>
+
+// Chase-Lev deque over a fixed ring. bottom is only written by the owner, top
+// only moves forward through a CAS, which is how owner and thieves agree on the
+// last job.
+struct JobDeque
+{
+	alignas(64) std::atomic<s64> top;
+	alignas(64) std::atomic<s64> bottom;
+	std::atomic<Job*> jobs[JOB_DEQUE_CAPACITY];
+};
+
+struct JobInjectionSlot
+{
+	std::atomic<u32> sequence;
+	Job* job;
+};
+
+// Multi-producer/multi-consumer bounded queue for jobs from threads outside the
+// pool, laid out like the logger's queue.
+struct JobInjectionQueue
+{
+	alignas(64) std::atomic<u32> enqueue_position;
+	alignas(64) std::atomic<u32> dequeue_position;
+	JobInjectionSlot slots[JOB_INJECTION_QUEUE_CAPACITY];
+};
+
+struct JobWorker
+{
+	JobDeque deque;
+	PlatformThread thread;
+	PlatformEvent wake_event;
+	alignas(64) std::atomic<bool> sleeping;
+};
+
+struct JobSystem
+{
+	std::atomic<bool> running;
+	// Grows as workers start, a worker only steals from ones already counted.
+	std::atomic<u32> worker_count;
+	JobInjectionQueue injection;
+	JobWorker workers[JOB_MAX_WORKERS];
+};
+
+static JobSystem job_system;
+
+// Index into job_system.workers, or -1 on threads outside the pool.
+static thread_local s32 current_worker = -1;
+static thread_local u32 steal_seed = 0;
+
+static bool push_job(JobDeque* deque, Job* job)
+{
+	s64 bottom = deque->bottom.load(std::memory_order_relaxed);
+	s64 top = deque->top.load(std::memory_order_acquire);
+	if (bottom - top >= JOB_DEQUE_CAPACITY)
+	{
+		return false;
+	}
+
+	// Thieves read bottom with acquire, so the release store publishes the slot.
+	deque->jobs[bottom & (JOB_DEQUE_CAPACITY - 1)].store(job, std::memory_order_relaxed);
+	deque->bottom.store(bottom + 1, std::memory_order_release);
+	return true;
+}
+
+// Owner only.
+static Job* pop_job(JobDeque* deque)
+{
+	s64 bottom = deque->bottom.load(std::memory_order_relaxed) - 1;
+	deque->bottom.store(bottom, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	s64 top = deque->top.load(std::memory_order_relaxed);
+
+	if (top > bottom)
+	{
+		deque->bottom.store(bottom + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	Job* job = deque->jobs[bottom & (JOB_DEQUE_CAPACITY - 1)].load(std::memory_order_relaxed);
+	if (top == bottom)
+	{
+		// The last job, a thief may be taking it too.
+		if (!deque->top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		{
+			job = nullptr;
+		}
+		deque->bottom.store(bottom + 1, std::memory_order_relaxed);
+	}
+	return job;
+}
+
+static Job* steal_job(JobDeque* deque)
+{
+	s64 top = deque->top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	s64 bottom = deque->bottom.load(std::memory_order_acquire);
+	if (top >= bottom)
+	{
+		return nullptr;
+	}
+
+	Job* job = deque->jobs[top & (JOB_DEQUE_CAPACITY - 1)].load(std::memory_order_relaxed);
+	if (!deque->top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+	{
+		return nullptr;
+	}
+	return job;
+}
+
+static bool inject_job(Job* job)
+{
+	JobInjectionQueue* queue = &job_system.injection;
+	u32 position = queue->enqueue_position.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		JobInjectionSlot* slot = &queue->slots[position & (JOB_INJECTION_QUEUE_CAPACITY - 1)];
+		s32 difference = (s32)(slot->sequence.load(std::memory_order_acquire) - position);
+		if (difference == 0)
+		{
+			if (queue->enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+			{
+				slot->job = job;
+				slot->sequence.store(position + 1, std::memory_order_release);
+				return true;
+			}
+		}
+		else if (difference < 0)
+		{
+			return false;
+		}
+		else
+		{
+			position = queue->enqueue_position.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+static Job* take_injected_job()
+{
+	JobInjectionQueue* queue = &job_system.injection;
+	u32 position = queue->dequeue_position.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		JobInjectionSlot* slot = &queue->slots[position & (JOB_INJECTION_QUEUE_CAPACITY - 1)];
+		s32 difference = (s32)(slot->sequence.load(std::memory_order_acquire) - (position + 1));
+		if (difference == 0)
+		{
+			if (queue->dequeue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+			{
+				Job* job = slot->job;
+				slot->sequence.store(position + JOB_INJECTION_QUEUE_CAPACITY, std::memory_order_release);
+				return job;
+			}
+		}
+		else if (difference < 0)
+		{
+			return nullptr;
+		}
+		else
+		{
+			position = queue->dequeue_position.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+// Own deque first, then the injection queue, then the other workers starting
+// from a random one so thieves spread out.
+static Job* find_job(s32 worker_index)
+{
+	Job* job = nullptr;
+	if (worker_index >= 0)
+	{
+		job = pop_job(&job_system.workers[worker_index].deque);
+		if (job)
+		{
+			return job;
+		}
+	}
+
+	job = take_injected_job();
+	if (job)
+	{
+		return job;
+	}
+
+	u32 worker_count = job_system.worker_count.load(std::memory_order_acquire);
+	if (steal_seed == 0)
+	{
+		steal_seed = 0x9E3779B9u * (u32)(worker_index + 2);
+	}
+	steal_seed ^= steal_seed << 13;
+	steal_seed ^= steal_seed >> 17;
+	steal_seed ^= steal_seed << 5;
+	u32 start = worker_count > 0 ? steal_seed % worker_count : 0;
+	for (u32 i = 0; i < worker_count; ++i)
+	{
+		u32 victim = (start + i) % worker_count;
+		if ((s32)victim == worker_index)
+		{
+			continue;
+		}
+
+		job = steal_job(&job_system.workers[victim].deque);
+		if (job)
+		{
+			return job;
+		}
+	}
+	return nullptr;
+}
+
+static void execute_job(Job* job)
+{
+	job->proc(job->data);
+	job->counter->value.fetch_sub(1, std::memory_order_release);
+}
+
+static bool has_queued_jobs()
+{
+	JobInjectionQueue* queue = &job_system.injection;
+	if (queue->enqueue_position.load(std::memory_order_relaxed) != queue->dequeue_position.load(std::memory_order_relaxed))
+	{
+		return true;
+	}
+	u32 worker_count = job_system.worker_count.load(std::memory_order_acquire);
+	for (u32 i = 0; i < worker_count; ++i)
+	{
+		JobDeque* deque = &job_system.workers[i].deque;
+		if (deque->bottom.load(std::memory_order_relaxed) > deque->top.load(std::memory_order_relaxed))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+static void wake_workers(u32 count)
+{
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	u32 worker_count = job_system.worker_count.load(std::memory_order_acquire);
+	for (u32 i = 1; i < worker_count && count > 0; ++i)
+	{
+		JobWorker* worker = &job_system.workers[i];
+		if (worker->sleeping.load(std::memory_order_relaxed) && worker->sleeping.exchange(false, std::memory_order_relaxed))
+		{
+			signal_event(&worker->wake_event);
+			count--;
+		}
+	}
+}
+
+static u32 job_worker_proc(void* data)
+{
+	s32 worker_index = (s32)(u64)data;
+	current_worker = worker_index;
+	JobWorker* worker = &job_system.workers[worker_index];
+
+	while (job_system.running.load(std::memory_order_acquire))
+	{
+		Job* job = find_job(worker_index);
+		if (job)
+		{
+			execute_job(job);
+			continue;
+		}
+
+		// Announce the sleep before the last look, so a submitter either sees the
+		// flag or this worker sees its job.
+		worker->sleeping.store(true, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (has_queued_jobs() || !job_system.running.load(std::memory_order_acquire))
+		{
+			worker->sleeping.store(false, std::memory_order_relaxed);
+			continue;
+		}
+		wait_for_event(&worker->wake_event, JOB_IDLE_TIMEOUT_MS);
+		worker->sleeping.store(false, std::memory_order_relaxed);
+	}
+	return 0;
+}
+
+bool initialize_jobs(const CpuTopology* topology)
+{
+	shutdown_jobs();
+
+	for (u32 i = 0; i < JOB_INJECTION_QUEUE_CAPACITY; ++i)
+	{
+		job_system.injection.slots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+	job_system.injection.enqueue_position.store(0, std::memory_order_relaxed);
+	job_system.injection.dequeue_position.store(0, std::memory_order_relaxed);
+
+	// One worker per physical core, SMT siblings would just fight over the same
+	// execution units. The fastest cores come first on hybrid CPUs so they are
+	// the ones kept if the count is capped.
+	u32 core_order[CPU_MAX_LOGICAL_PROCESSORS];
+	u32 core_count = topology ? topology->core_count : 0;
+	for (u32 i = 0; i < core_count; ++i)
+	{
+		u32 j = i;
+		while (j > 0 && topology->cores[core_order[j - 1]].efficiency_class < topology->cores[i].efficiency_class)
+		{
+			core_order[j] = core_order[j - 1];
+			j--;
+		}
+		core_order[j] = i;
+	}
+
+	u32 worker_count = core_count > 1 ? core_count : 1;
+	if (worker_count > JOB_MAX_WORKERS)
+	{
+		worker_count = JOB_MAX_WORKERS;
+	}
+
+	for (u32 i = 0; i < worker_count; ++i)
+	{
+		JobWorker* worker = &job_system.workers[i];
+		worker->deque.top.store(0, std::memory_order_relaxed);
+		worker->deque.bottom.store(0, std::memory_order_relaxed);
+		worker->sleeping.store(false, std::memory_order_relaxed);
+	}
+
+	// The calling thread is worker 0 and keeps its own affinity.
+	current_worker = 0;
+	job_system.worker_count.store(1, std::memory_order_relaxed);
+	job_system.running.store(true, std::memory_order_release);
+
+	for (u32 i = 1; i < worker_count; ++i)
+	{
+		JobWorker* worker = &job_system.workers[i];
+		if (!create_event(&worker->wake_event))
+		{
+			break;
+		}
+
+		char name[32];
+		snprintf(name, sizeof(name), "job worker %u", i);
+		if (!create_thread(&worker->thread, job_worker_proc, (void*)(u64)i, name))
+		{
+			destroy_event(&worker->wake_event);
+			break;
+		}
+		set_thread_affinity(&worker->thread, topology->cores[core_order[i]].processor_mask);
+		job_system.worker_count.store(i + 1, std::memory_order_release);
+	}
+
+	u32 started_count = job_system.worker_count.load(std::memory_order_relaxed);
+	LOG_CAT_INFO(PLATFORM, "Job system running %u workers.", started_count);
+	return started_count == worker_count;
+}
+
+void shutdown_jobs()
+{
+	if (!job_system.running.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	job_system.running.store(false, std::memory_order_release);
+	u32 worker_count = job_system.worker_count.load(std::memory_order_relaxed);
+	for (u32 i = 1; i < worker_count; ++i)
+	{
+		signal_event(&job_system.workers[i].wake_event);
+	}
+	for (u32 i = 1; i < worker_count; ++i)
+	{
+		JobWorker* worker = &job_system.workers[i];
+		if (!join_thread(&worker->thread, JOB_SHUTDOWN_TIMEOUT_MS))
+		{
+			// A job is still running, its event has to outlive it.
+			LOG_CAT_WARN(PLATFORM, "Job worker %u did not exit within %u ms.", i, JOB_SHUTDOWN_TIMEOUT_MS);
+			continue;
+		}
+		destroy_event(&worker->wake_event);
+	}
+
+	job_system.worker_count.store(0, std::memory_order_relaxed);
+	current_worker = -1;
+}
+
+u32 get_job_worker_count()
+{
+	return job_system.worker_count.load(std::memory_order_relaxed);
+}
+
+void run_jobs(Job* jobs, u32 count, JobCounter* counter)
+{
+	counter->value.fetch_add(count, std::memory_order_relaxed);
+
+	s32 worker_index = current_worker;
+	u32 queued = 0;
+	for (u32 i = 0; i < count; ++i)
+	{
+		Job* job = &jobs[i];
+		job->counter = counter;
+
+		bool pushed = false;
+		if (job_system.running.load(std::memory_order_relaxed))
+		{
+			pushed = worker_index >= 0 ? push_job(&job_system.workers[worker_index].deque, job) : inject_job(job);
+		}
+		if (!pushed)
+		{
+			// Full queue or no job system, run it here rather than drop it.
+			execute_job(job);
+			continue;
+		}
+		queued++;
+	}
+
+	if (queued > 0)
+	{
+		wake_workers(queued);
+	}
+}
+
+void wait_for_counter(JobCounter* counter, u32 value)
+{
+	s32 worker_index = current_worker;
+	while (counter->value.load(std::memory_order_acquire) > value)
+	{
+		Job* job = job_system.running.load(std::memory_order_relaxed) ? find_job(worker_index) : nullptr;
+		if (job)
+		{
+			execute_job(job);
+		}
+		else
+		{
+			yield_thread();
+		}
+	}
+}
\ No newline at end of file
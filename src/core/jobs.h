@@ -0,0 +1,52 @@
+#pragma once
+
+#include "core/core_types.h"
+#include "core/platform/platform.h"
+
+#include <atomic>
+
+// A work-stealing job system. The thread that calls initialize_jobs is worker 0
+// and one more worker runs on each remaining physical core. Each worker owns a
+// Chase-Lev deque: it pushes and pops its own jobs at the bottom without locks
+// while idle workers steal from the top. Threads outside the pool submit through
+// a shared injection queue.
+//
+// Jobs report completion through a JobCounter. Waiting on a counter runs other
+// jobs until it drops, so a waiting worker never leaves its core idle.
+#define JOB_MAX_WORKERS 32
+// Per worker, must be a power of two. A job that doesn't fit runs immediately
+// on the submitting thread.
+#define JOB_DEQUE_CAPACITY 1024
+#define JOB_INJECTION_QUEUE_CAPACITY 1024
+// How long an idle worker sleeps before looking for work again, bounds the
+// latency of a missed wake up.
+#define JOB_IDLE_TIMEOUT_MS 2
+#define JOB_SHUTDOWN_TIMEOUT_MS 1000
+
+typedef void (*JobProc)(void* data);
+
+struct JobCounter
+{
+	std::atomic<u32> value;
+};
+
+// Jobs are referenced, not copied, so they must stay alive until their counter
+// has been waited on.
+struct Job
+{
+	JobProc proc;
+	void* data;
+	JobCounter* counter; // Set by run_jobs.
+};
+
+// Without topology only the calling thread runs jobs.
+bool initialize_jobs(const CpuTopology* topology);
+// Jobs still queued are dropped, wait on every counter first.
+void shutdown_jobs();
+// Including worker 0.
+u32 get_job_worker_count();
+
+// Adds count to counter and queues the jobs. Each finished job takes one off.
+void run_jobs(Job* jobs, u32 count, JobCounter* counter);
+// Runs queued jobs until counter is at or below value.
+void wait_for_counter(JobCounter* counter, u32 value = 0);
\ No newline at end of file
@@ -0,0 +1,53 @@
+#include "core/latency_histogram.h"
+
+void reset_latency_histogram(LatencyHistogram* histogram)
+{
+	*histogram = {};
+}
+
+void add_latency_sample(LatencyHistogram* histogram, f64 milliseconds)
+{
+	if (milliseconds < 0.0)
+	{
+		milliseconds = 0.0;
+	}
+
+	u32 bucket = (u32)(milliseconds / LATENCY_HISTOGRAM_BUCKET_MS);
+	if (bucket >= LATENCY_HISTOGRAM_BUCKET_COUNT)
+	{
+		bucket = LATENCY_HISTOGRAM_BUCKET_COUNT - 1;
+	}
+
+	histogram->buckets[bucket]++;
+	histogram->sample_count++;
+	if (milliseconds > histogram->max_ms)
+	{
+		histogram->max_ms = milliseconds;
+	}
+}
+
+f64 get_latency_percentile(const LatencyHistogram* histogram, f64 percentile)
+{
+	if (histogram->sample_count == 0)
+	{
+		return 0.0;
+	}
+
+	// Rank of the sample we're after, rounded up so p100 is the last sample.
+	u32 rank = (u32)(percentile * (f64)histogram->sample_count + 0.999999);
+	if (rank == 0)
+	{
+		rank = 1;
+	}
+
+	u32 seen = 0;
+	for (u32 i = 0; i < LATENCY_HISTOGRAM_BUCKET_COUNT; ++i)
+	{
+		seen += histogram->buckets[i];
+		if (seen >= rank)
+		{
+			return (i == LATENCY_HISTOGRAM_BUCKET_COUNT - 1) ? histogram->max_ms : (f64)(i + 1) * LATENCY_HISTOGRAM_BUCKET_MS;
+		}
+	}
+	return histogram->max_ms;
+}
\ No newline at end of file
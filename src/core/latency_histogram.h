@@ -0,0 +1,19 @@
+#pragma once
+
+#include "core/core_types.h"
+
+// Fixed width buckets, anything past the last bucket lands in it.
+#define LATENCY_HISTOGRAM_BUCKET_COUNT 256
+#define LATENCY_HISTOGRAM_BUCKET_MS 0.25
+
+struct LatencyHistogram
+{
+	u32 buckets[LATENCY_HISTOGRAM_BUCKET_COUNT];
+	u32 sample_count;
+	f64 max_ms;
+};
+
+void reset_latency_histogram(LatencyHistogram* histogram);
+void add_latency_sample(LatencyHistogram* histogram, f64 milliseconds);
+// Upper edge of the bucket holding the percentile (0..1), 0 if there are no samples.
+f64 get_latency_percentile(const LatencyHistogram* histogram, f64 percentile);
\ No newline at end of file
@@ -1,47 +1,801 @@
 #include "core/logger.h"
+#include "core/heap.h"
+#include "core/platform/platform.h"
 
-#include <memory>
-#include <varargs.h>
+#include <atomic>
 #include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
 
-// TODO: Move to platform layer.
-#define WIN32_LEAN_AND_MEAN
-#include <Windows.h>
+// Number of records in the ring buffer. Must be a power of two.
+static const u32 LOG_QUEUE_CAPACITY = 4096;
+// Messages longer than this are truncated.
+static const u32 LOG_MESSAGE_LENGTH = 500;
+// How long the logger thread sleeps when the queue is empty. This bounds the
+// latency of a message if the wake up signal is missed.
+static const u32 LOG_IDLE_TIMEOUT_MS = 10;
+static const u32 LOG_SHUTDOWN_TIMEOUT_MS = 1000;
+// Number of distinct format strings the binary writer remembers. Must be a power of two.
+static const u32 LOG_FORMAT_TABLE_SIZE = 4096;
+static const u64 LOG_DEFAULT_SEGMENT_SIZE = 4 * 1024 * 1024;
+static const u32 LOG_DEFAULT_MAX_SEGMENTS = 4;
+static const u32 LOG_MAX_PATH = 260;
 
-bool initialize_logging()
+static_assert(LOG_BINARY_ARGS_SIZE <= LOG_MESSAGE_LENGTH, "Binary log arguments must fit in a record.");
+
+struct LogRecord
+{
+	std::atomic<u32> sequence;
+	LogLevel level;
+	bool binary;
+	u16 length;
+	// Binary records only. The message holds the packed arguments.
+	u64 timestamp;
+	const char* format;
+	char message[LOG_MESSAGE_LENGTH];
+};
+
+// Multi-producer/single-consumer bounded queue. Producers claim a slot by bumping
+// enqueue_position and publish it through the slot's sequence number; the logger
+// thread is the only consumer.
+struct Logger
+{
+	alignas(64) std::atomic<u32> enqueue_position;
+	alignas(64) std::atomic<u32> dequeue_position;
+	alignas(64) std::atomic<u32> written_position;
+	std::atomic<u32> dropped_count;
+	std::atomic<u64> total_dropped_count;
+	std::atomic<u32> flush_requests;
+	// Bumped by each flush. The logger thread reports every suppressed site in the
+	// pass that sees a new generation, then publishes it as written.
+	std::atomic<u32> flush_generation;
+	std::atomic<u32> written_flush_generation;
+	std::atomic<bool> consumer_sleeping;
+	std::atomic<bool> running;
+
+	PlatformThread thread;
+	PlatformEvent wake_event;
+	PlatformEvent flush_event;
+
+	u64 site_window_ticks;
+	// Sites that suppressed a message since the logger thread last looked.
+	std::atomic<LogSite*> new_suppressed_sites;
+
+	// Only touched by the logger thread.
+	bool console_output;
+	PlatformMappedFile text_file;
+	u64 text_file_offset;
+	u64 text_file_segment_size;
+	u32 max_text_file_segments;
+	char text_file_path[LOG_MAX_PATH];
+	FILE* binary_file;
+	const char* known_formats[LOG_FORMAT_TABLE_SIZE];
+	LogSite* suppressed_sites; // Waiting for their window to end.
+
+	// LOG_QUEUE_CAPACITY records from the logging heap.
+	LogRecord* records;
+};
+
+static Logger logger;
+
+#define LOG_ALL_LEVELS_MASK 0x3F
+
+std::atomic<u8> log_category_masks[(u8)LogCategory::LOG_CATEGORY_MAX_CATEGORIES] =
+{
+	LOG_ALL_LEVELS_MASK, LOG_ALL_LEVELS_MASK, LOG_ALL_LEVELS_MASK, LOG_ALL_LEVELS_MASK, LOG_ALL_LEVELS_MASK, LOG_ALL_LEVELS_MASK
+};
+
+static const char* category_names[(u8)LogCategory::LOG_CATEGORY_MAX_CATEGORIES] = { "general", "renderer", "input", "platform", "assets", "memory" };
+static const char* level_names[6] = { "fatal", "error", "warn", "info", "debug", "trace" };
+
+static const char* level_strings[6] = { "[FATAL]: ", "[ERROR]: ", "[WARN]: ", "[INFO]: ", "[DEBUG]: ","[TRACE]: " };
+static const ConsoleColor level_colors[6] =
+{
+	ConsoleColor::CONSOLE_COLOR_RED_BACKGROUND,
+	ConsoleColor::CONSOLE_COLOR_RED,
+	ConsoleColor::CONSOLE_COLOR_YELLOW,
+	ConsoleColor::CONSOLE_COLOR_GREEN,
+	ConsoleColor::CONSOLE_COLOR_BLUE,
+	ConsoleColor::CONSOLE_COLOR_GREY
+};
+
+// Lines of the same level are batched into a single console write.
+struct LogWriteBuffer
+{
+	LogLevel level;
+	u32 length;
+	char data[8192];
+};
+
+// Shifts <path> to <path>.1, <path>.1 to <path>.2 and so on, deleting the oldest.
+static void rotate_log_files()
+{
+	char from[LOG_MAX_PATH + 16];
+	char to[LOG_MAX_PATH + 16];
+
+	snprintf(to, sizeof(to), "%s.%u", logger.text_file_path, logger.max_text_file_segments - 1);
+	remove(to);
+
+	for (u32 i = logger.max_text_file_segments - 1; i > 0; --i)
+	{
+		if (i == 1)
+		{
+			snprintf(from, sizeof(from), "%s", logger.text_file_path);
+		}
+		else
+		{
+			snprintf(from, sizeof(from), "%s.%u", logger.text_file_path, i - 1);
+		}
+		snprintf(to, sizeof(to), "%s.%u", logger.text_file_path, i);
+		rename(from, to);
+	}
+}
+
+static bool open_log_file()
+{
+	logger.text_file_offset = 0;
+	return create_mapped_file(&logger.text_file, logger.text_file_path, logger.text_file_segment_size);
+}
+
+static void close_log_file()
+{
+	close_mapped_file(&logger.text_file, logger.text_file_offset);
+}
+
+static void write_log_file(const char* data, u32 length)
+{
+	if (logger.text_file.data == nullptr)
+	{
+		return;
+	}
+
+	if (logger.text_file_offset + length > logger.text_file.size)
+	{
+		close_log_file();
+		if (logger.max_text_file_segments > 1)
+		{
+			rotate_log_files();
+		}
+		if (!open_log_file())
+		{
+			return;
+		}
+	}
+
+	memcpy(logger.text_file.data + logger.text_file_offset, data, length);
+	logger.text_file_offset += length;
+}
+
+static void flush_write_buffer(LogWriteBuffer* buffer)
+{
+	if (buffer->length == 0)
+	{
+		return;
+	}
+
+	write_log_file(buffer->data, buffer->length);
+
+	if (logger.console_output)
+	{
+		buffer->data[buffer->length] = '\0';
+		write_debug_output(buffer->data);
+		write_console(buffer->data, buffer->length, level_colors[(u8)buffer->level]);
+	}
+	buffer->length = 0;
+}
+
+static void append_line(LogWriteBuffer* buffer, LogLevel level, const char* message, u32 length)
 {
-	// TODO: Create a log file to output to.
+	const char* prefix = level_strings[(u8)level];
+	u32 prefix_length = (u32)strlen(prefix);
+	u32 line_length = prefix_length + length + 1;
+
+	if (buffer->level != level || buffer->length + line_length >= sizeof(buffer->data))
+	{
+		flush_write_buffer(buffer);
+		buffer->level = level;
+	}
+
+	memcpy(buffer->data + buffer->length, prefix, prefix_length);
+	memcpy(buffer->data + buffer->length + prefix_length, message, length);
+	buffer->data[buffer->length + prefix_length + length] = '\n';
+	buffer->length += line_length;
+}
+
+static void write_dropped_notice(LogWriteBuffer* buffer)
+{
+	u32 dropped = logger.dropped_count.exchange(0, std::memory_order_relaxed);
+	if (dropped > 0)
+	{
+		char message[64];
+		s32 length = snprintf(message, sizeof(message), "Logger queue full, dropped %u messages.", dropped);
+		append_line(buffer, LogLevel::LOG_LEVEL_WARN, message, (u32)length);
+	}
+}
+
+// Reports how many messages each site suppressed once its window has ended, or
+// right away when forced.
+static void write_suppressed_notices(LogWriteBuffer* buffer, bool force)
+{
+	LogSite* site = logger.new_suppressed_sites.exchange(nullptr, std::memory_order_acquire);
+	while (site)
+	{
+		LogSite* next = site->next_pending;
+		site->next_pending = logger.suppressed_sites;
+		logger.suppressed_sites = site;
+		site = next;
+	}
+
+	u64 now = read_timestamp();
+	LogSite** link = &logger.suppressed_sites;
+	while (*link)
+	{
+		site = *link;
+		// A producer starting the next window also ends this one.
+		bool window_ended = site->window_start.load(std::memory_order_relaxed) != site->pending_window || now - site->pending_window >= logger.site_window_ticks;
+		if (!force && !window_ended)
+		{
+			link = &site->next_pending;
+			continue;
+		}
+
+		// Cleared before taking the count, a message suppressed in between queues the site again.
+		*link = site->next_pending;
+		site->pending.store(false, std::memory_order_seq_cst);
+		u32 suppressed = site->suppressed_count.exchange(0, std::memory_order_seq_cst);
+		if (suppressed > 0)
+		{
+			char message[LOG_MESSAGE_LENGTH];
+			s32 length = snprintf(message, sizeof(message), "Suppressed %u more messages from %s:%u.", suppressed, site->file, site->line);
+			length = (length < 0) ? 0 : (length >= (s32)LOG_MESSAGE_LENGTH ? LOG_MESSAGE_LENGTH - 1 : length);
+			append_line(buffer, site->level, message, (u32)length);
+		}
+	}
+}
+
+// Writes the format string the first time it's seen so the decoder can resolve
+// the format ids of the entries that follow.
+static void write_binary_format(const char* format)
+{
+	u64 hash = ((u64)format * 0x9E3779B97F4A7C15ull) >> 32;
+	for (u32 probe = 0; probe < LOG_FORMAT_TABLE_SIZE; ++probe)
+	{
+		const char** slot = &logger.known_formats[(hash + probe) & (LOG_FORMAT_TABLE_SIZE - 1)];
+		if (*slot == format)
+		{
+			return;
+		}
+		if (*slot == nullptr)
+		{
+			*slot = format;
+			break;
+		}
+	}
+
+	// If the table is full the format is written again, the decoder keeps the latest definition.
+	u8 kind = (u8)LogBinaryRecordKind::LOG_BINARY_RECORD_FORMAT;
+	u64 format_id = (u64)format;
+	u32 length = (u32)strlen(format);
+	fwrite(&kind, sizeof(kind), 1, logger.binary_file);
+	fwrite(&format_id, sizeof(format_id), 1, logger.binary_file);
+	fwrite(&length, sizeof(length), 1, logger.binary_file);
+	fwrite(format, 1, length, logger.binary_file);
+}
+
+static void write_binary_entry(LogRecord* record)
+{
+	if (logger.binary_file == nullptr)
+	{
+		return;
+	}
+
+	write_binary_format(record->format);
+
+	u8 kind = (u8)LogBinaryRecordKind::LOG_BINARY_RECORD_ENTRY;
+	u8 level = (u8)record->level;
+	u64 format_id = (u64)record->format;
+	fwrite(&kind, sizeof(kind), 1, logger.binary_file);
+	fwrite(&level, sizeof(level), 1, logger.binary_file);
+	fwrite(&record->timestamp, sizeof(record->timestamp), 1, logger.binary_file);
+	fwrite(&format_id, sizeof(format_id), 1, logger.binary_file);
+	fwrite(&record->length, sizeof(record->length), 1, logger.binary_file);
+	fwrite(record->message, 1, record->length, logger.binary_file);
+}
+
+// Writes the published records, at most one lap of the ring so flushes are not
+// starved by producers that keep the queue busy. Returns the number of records written.
+static u32 drain_queue(LogWriteBuffer* buffer)
+{
+	// A flush or shutdown also reports sites still inside their window.
+	u32 flush_generation = logger.flush_generation.load(std::memory_order_acquire);
+	bool force_notices = flush_generation != logger.written_flush_generation.load(std::memory_order_relaxed) || !logger.running.load(std::memory_order_acquire);
+
+	u32 count = 0;
+	u32 binary_count = 0;
+	u32 position = logger.dequeue_position.load(std::memory_order_relaxed);
+
+	while (count < LOG_QUEUE_CAPACITY)
+	{
+		LogRecord* record = &logger.records[position & (LOG_QUEUE_CAPACITY - 1)];
+		if (record->sequence.load(std::memory_order_acquire) != position + 1)
+		{
+			break;
+		}
+
+		if (record->binary)
+		{
+			write_binary_entry(record);
+			binary_count++;
+		}
+		else
+		{
+			append_line(buffer, record->level, record->message, record->length);
+		}
+
+		// Hand the slot back to the producers for the next lap around the ring.
+		record->sequence.store(position + LOG_QUEUE_CAPACITY, std::memory_order_release);
+		position++;
+		count++;
+	}
+
+	logger.dequeue_position.store(position, std::memory_order_relaxed);
+
+	write_suppressed_notices(buffer, force_notices);
+	write_dropped_notice(buffer);
+	flush_write_buffer(buffer);
+	if (binary_count > 0)
+	{
+		fflush(logger.binary_file);
+	}
+	logger.written_position.store(position, std::memory_order_release);
+	logger.written_flush_generation.store(flush_generation, std::memory_order_release);
+
+	if ((count > 0 || force_notices) && logger.flush_requests.load(std::memory_order_relaxed) > 0)
+	{
+		signal_event(&logger.flush_event);
+	}
+
+	return count;
+}
+
+static u32 logger_thread_proc(void* data)
+{
+	static LogWriteBuffer buffer = {};
+
+	while (logger.running.load(std::memory_order_acquire))
+	{
+		if (drain_queue(&buffer) > 0)
+		{
+			continue;
+		}
+
+		logger.consumer_sleeping.store(true, std::memory_order_seq_cst);
+
+		// A producer may have published between the drain and setting the flag.
+		LogRecord* next = &logger.records[logger.dequeue_position.load(std::memory_order_relaxed) & (LOG_QUEUE_CAPACITY - 1)];
+		if (next->sequence.load(std::memory_order_acquire) != logger.dequeue_position.load(std::memory_order_relaxed) + 1)
+		{
+			wait_for_event(&logger.wake_event, LOG_IDLE_TIMEOUT_MS);
+		}
+
+		logger.consumer_sleeping.store(false, std::memory_order_relaxed);
+	}
+
+	// Write out anything queued before shutdown.
+	drain_queue(&buffer);
+	return 0;
+}
+
+static void wake_logger_thread()
+{
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (logger.consumer_sleeping.load(std::memory_order_relaxed))
+	{
+		signal_event(&logger.wake_event);
+	}
+}
+
+// Used before the logger thread starts and after it stops.
+static void write_synchronous(LogLevel level, const char* message, u32 length)
+{
+	LogWriteBuffer buffer;
+	buffer.level = level;
+	buffer.length = 0;
+	append_line(&buffer, level, message, length);
+
+	buffer.data[buffer.length] = '\0';
+	write_debug_output(buffer.data);
+	write_console(buffer.data, buffer.length, level_colors[(u8)level]);
+}
+
+bool log_site_allow(LogSite* site)
+{
+	// Sites aren't limited until the logger knows the timer frequency.
+	u64 window_ticks = logger.site_window_ticks;
+	if (window_ticks == 0)
+	{
+		return true;
+	}
+
+	u64 now = read_timestamp();
+	u64 window_start = site->window_start.load(std::memory_order_relaxed);
+	if (now - window_start >= window_ticks)
+	{
+		// Only one thread gets to start the new window. Threads racing past the
+		// boundary may let a message or two extra through, which is fine.
+		if (site->window_start.compare_exchange_strong(window_start, now, std::memory_order_relaxed))
+		{
+			site->window_count.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	if (site->window_count.fetch_add(1, std::memory_order_relaxed) < LOG_SITE_BURST)
+	{
+		return true;
+	}
+
+	// The first suppressed message queues the site for the logger thread to report.
+	site->suppressed_count.fetch_add(1, std::memory_order_seq_cst);
+	if (!site->pending.exchange(true, std::memory_order_seq_cst))
+	{
+		site->pending_window = site->window_start.load(std::memory_order_relaxed);
+		LogSite* head = logger.new_suppressed_sites.load(std::memory_order_relaxed);
+		do
+		{
+			site->next_pending = head;
+		} while (!logger.new_suppressed_sites.compare_exchange_weak(head, site, std::memory_order_release, std::memory_order_relaxed));
+	}
+	return false;
+}
+
+void set_log_level(LogCategory category, LogLevel max_level)
+{
+	u8 mask = (u8)((2u << (u8)max_level) - 1) | 1;
+	log_category_masks[(u8)category].store(mask, std::memory_order_relaxed);
+}
+
+LogLevel get_log_level(LogCategory category)
+{
+	u8 mask = log_category_masks[(u8)category].load(std::memory_order_relaxed);
+	u8 level = 0;
+	while (level < (u8)LogLevel::LOG_LEVEL_TRACE && (mask >> (level + 1)) & 1)
+	{
+		level++;
+	}
+	return (LogLevel)level;
+}
+
+static bool match_name(const char* name, const char* begin, const char* end)
+{
+	u64 length = end - begin;
+	return strlen(name) == length && strncmp(name, begin, length) == 0;
+}
+
+bool configure_log_levels(const char* config)
+{
+	bool valid = true;
+	const char* entry = config;
+
+	while (*entry)
+	{
+		const char* entry_end = strchr(entry, ',');
+		if (entry_end == nullptr)
+		{
+			entry_end = entry + strlen(entry);
+		}
+
+		const char* equals = (const char*)memchr(entry, '=', entry_end - entry);
+		s32 level = -1;
+		if (equals)
+		{
+			for (u8 i = 0; i < 6; ++i)
+			{
+				if (match_name(level_names[i], equals + 1, entry_end))
+				{
+					level = i;
+				}
+			}
+		}
+
+		bool matched = false;
+		if (level >= 0)
+		{
+			for (u8 i = 0; i < (u8)LogCategory::LOG_CATEGORY_MAX_CATEGORIES; ++i)
+			{
+				if (match_name("*", entry, equals) || match_name(category_names[i], entry, equals))
+				{
+					set_log_level((LogCategory)i, (LogLevel)level);
+					matched = true;
+				}
+			}
+		}
+
+		if (!matched)
+		{
+			LOG_CAT_WARN(PLATFORM, "Ignoring invalid log level setting '%.*s'.", (s32)(entry_end - entry), entry);
+			valid = false;
+		}
+
+		entry = (*entry_end == ',') ? entry_end + 1 : entry_end;
+	}
+
+	return valid;
+}
+
+static void free_log_records()
+{
+	free_to_heap(get_heap(HeapId::HEAP_ID_LOGGING), logger.records);
+	logger.records = nullptr;
+}
+
+bool initialize_logging(const LogConfig* config)
+{
+	LogConfig default_config = {};
+	default_config.console_output = true;
+	default_config.file_path = LOG_DEFAULT_FILE_PATH;
+	default_config.file_segment_size = LOG_DEFAULT_SEGMENT_SIZE;
+	default_config.max_file_segments = LOG_DEFAULT_MAX_SEGMENTS;
+	if (config == nullptr)
+	{
+		config = &default_config;
+	}
+
+	logger.site_window_ticks = get_timestamp_frequency() * LOG_SITE_WINDOW_MS / 1000;
+	logger.console_output = config->console_output;
+	logger.text_file = {};
+	logger.text_file_offset = 0;
+	if (config->file_path)
+	{
+		// A segment must hold at least one full write buffer.
+		snprintf(logger.text_file_path, sizeof(logger.text_file_path), "%s", config->file_path);
+		logger.text_file_segment_size = config->file_segment_size < sizeof(LogWriteBuffer::data) ? sizeof(LogWriteBuffer::data) : config->file_segment_size;
+		logger.max_text_file_segments = config->max_file_segments > 0 ? config->max_file_segments : 1;
+
+		// Keep the previous run's log around, it may be the only record of a crash.
+		if (logger.max_text_file_segments > 1)
+		{
+			rotate_log_files();
+		}
+		open_log_file();
+	}
+
+	logger.records = allocate_heap_array<LogRecord>(get_heap(HeapId::HEAP_ID_LOGGING), LOG_QUEUE_CAPACITY, MEMORY_SITE(LOGGING));
+	if (logger.records == nullptr)
+	{
+		close_log_file();
+		return false;
+	}
+
+	for (u32 i = 0; i < LOG_QUEUE_CAPACITY; ++i)
+	{
+		logger.records[i].sequence.store(i, std::memory_order_relaxed);
+	}
+	logger.enqueue_position.store(0, std::memory_order_relaxed);
+	logger.dequeue_position.store(0, std::memory_order_relaxed);
+	logger.written_position.store(0, std::memory_order_relaxed);
+	logger.dropped_count.store(0, std::memory_order_relaxed);
+	logger.total_dropped_count.store(0, std::memory_order_relaxed);
+	logger.flush_requests.store(0, std::memory_order_relaxed);
+	logger.flush_generation.store(0, std::memory_order_relaxed);
+	logger.written_flush_generation.store(0, std::memory_order_relaxed);
+	logger.consumer_sleeping.store(false, std::memory_order_relaxed);
+
+#if LOG_BINARY_ENABLED
+	memset(logger.known_formats, 0, sizeof(logger.known_formats));
+	logger.binary_file = fopen(LOG_BINARY_FILE_PATH, "wb");
+	if (logger.binary_file)
+	{
+		LogBinaryHeader header = {};
+		header.magic = LOG_BINARY_MAGIC;
+		header.version = LOG_BINARY_VERSION;
+		header.timestamp_frequency = get_timestamp_frequency();
+		header.start_timestamp = read_timestamp();
+		fwrite(&header, sizeof(header), 1, logger.binary_file);
+	}
+#endif
+
+	if (!create_event(&logger.wake_event))
+	{
+		free_log_records();
+		close_log_file();
+		return false;
+	}
+
+	if (!create_event(&logger.flush_event))
+	{
+		destroy_event(&logger.wake_event);
+		free_log_records();
+		close_log_file();
+		return false;
+	}
+
+	logger.running.store(true, std::memory_order_release);
+	if (!create_thread(&logger.thread, logger_thread_proc, nullptr, "logger"))
+	{
+		logger.running.store(false, std::memory_order_release);
+		destroy_event(&logger.wake_event);
+		destroy_event(&logger.flush_event);
+		free_log_records();
+		close_log_file();
+		return false;
+	}
+
+	return true;
+}
+
+bool shutdown_logging()
+{
+	if (!logger.running.load(std::memory_order_acquire))
+	{
+		return true;
+	}
+
+	// The logger thread drains the queue before exiting.
+	logger.running.store(false, std::memory_order_release);
+	signal_event(&logger.wake_event);
+
+	if (!join_thread(&logger.thread, LOG_SHUTDOWN_TIMEOUT_MS))
+	{
+		return false;
+	}
+
+	destroy_event(&logger.wake_event);
+	destroy_event(&logger.flush_event);
+	free_log_records();
+	close_log_file();
+
+	if (logger.binary_file)
+	{
+		fclose(logger.binary_file);
+		logger.binary_file = nullptr;
+	}
 	return true;
 }
 
-void shutdown_logging()
+bool flush_logging(u32 timeout_ms)
+{
+	if (!logger.running.load(std::memory_order_acquire))
+	{
+		return true;
+	}
+
+	u32 target = logger.enqueue_position.load(std::memory_order_acquire);
+	u32 generation = logger.flush_generation.fetch_add(1, std::memory_order_acq_rel) + 1;
+
+	logger.flush_requests.fetch_add(1, std::memory_order_relaxed);
+	bool flushed = false;
+	for (u32 waited_ms = 0; waited_ms < timeout_ms; ++waited_ms)
+	{
+		if ((s32)(logger.written_position.load(std::memory_order_acquire) - target) >= 0 &&
+			(s32)(logger.written_flush_generation.load(std::memory_order_acquire) - generation) >= 0)
+		{
+			flushed = true;
+			break;
+		}
+
+		signal_event(&logger.wake_event);
+		wait_for_event(&logger.flush_event, 1);
+	}
+	logger.flush_requests.fetch_sub(1, std::memory_order_relaxed);
+
+	return flushed;
+}
+
+u64 get_dropped_log_count()
 {
-	// TODO: Cleanup logging/write queued entries.
+	return logger.total_dropped_count.load(std::memory_order_relaxed);
 }
 
-void log_output(LogLevel level, const char* message, ...)
+// Claims a slot in the queue. Returns nullptr if the message was dropped.
+static LogRecord* claim_record(LogLevel level, u32* out_position)
 {
-	const char* level_strings[6] = { "[FATAL]: ", "[ERROR]: ", "[WARN]: ", "[INFO]: ", "[DEBUG]: ","[TRACE]: " };
 	bool is_error = level < LogLevel::LOG_LEVEL_WARN;
 
-	// Currently we only support a message length of 16000 characters.
-	const s32 msg_length = 16000;
-	char out_message[msg_length];
-	memset(out_message, 0, sizeof(out_message));
+	u32 position = logger.enqueue_position.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		LogRecord* record = &logger.records[position & (LOG_QUEUE_CAPACITY - 1)];
+		u32 sequence = record->sequence.load(std::memory_order_acquire);
+		s32 difference = (s32)(sequence - position);
+
+		if (difference == 0)
+		{
+			if (logger.enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+			{
+				*out_position = position;
+				return record;
+			}
+		}
+		else if (difference < 0)
+		{
+			// The queue is full. Errors wait for space, everything else is dropped.
+			if (!is_error)
+			{
+				logger.dropped_count.fetch_add(1, std::memory_order_relaxed);
+				logger.total_dropped_count.fetch_add(1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			wake_logger_thread();
+			yield_thread();
+			position = logger.enqueue_position.load(std::memory_order_relaxed);
+		}
+		else
+		{
+			position = logger.enqueue_position.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+static void publish_record(LogRecord* record, u32 position)
+{
+	record->sequence.store(position + 1, std::memory_order_release);
+	wake_logger_thread();
+}
+
+bool log_output(LogLevel level, const char* message, ...)
+{
+	if (!logger.running.load(std::memory_order_acquire))
+	{
+		char out_message[LOG_MESSAGE_LENGTH];
+
+		va_list arg_ptr;
+		va_start(arg_ptr, message);
+		s32 length = vsnprintf(out_message, LOG_MESSAGE_LENGTH, message, arg_ptr);
+		va_end(arg_ptr);
+
+		length = (length < 0) ? 0 : (length >= (s32)LOG_MESSAGE_LENGTH ? LOG_MESSAGE_LENGTH - 1 : length);
+		write_synchronous(level, out_message, (u32)length);
+		return true;
+	}
+
+	u32 position;
+	LogRecord* record = claim_record(level, &position);
+	if (record == nullptr)
+	{
+		return false;
+	}
 
 	va_list arg_ptr;
 	va_start(arg_ptr, message);
-	vsnprintf(out_message, msg_length, message, arg_ptr);
+	s32 length = vsnprintf(record->message, LOG_MESSAGE_LENGTH, message, arg_ptr);
 	va_end(arg_ptr);
 
-	char out_message2[msg_length];
-	sprintf(out_message2, "%s%s\n", level_strings[(u8)level], out_message);
+	record->level = level;
+	record->binary = false;
+	record->length = (u16)((length < 0) ? 0 : (length >= (s32)LOG_MESSAGE_LENGTH ? LOG_MESSAGE_LENGTH - 1 : length));
+	publish_record(record, position);
 
-	HANDLE console_handle = GetStdHandle(STD_OUTPUT_HANDLE);
-	static u8 levels[6] = { 64, 4, 6, 2, 1, 8 };
-	SetConsoleTextAttribute(console_handle, levels[(u8)level]);
-	OutputDebugStringA(out_message2);
-	u64 length = strlen(out_message2);
-	LPDWORD number_written = 0;
-	WriteConsoleA(console_handle, out_message2, (DWORD)length, number_written, 0);
+	if (level == LogLevel::LOG_LEVEL_FATAL)
+	{
+		flush_logging();
+	}
+	return true;
+}
+
+bool log_binary_output(LogLevel level, const char* format, const LogArgBuffer* args)
+{
+	// Binary records can't be written without the logger thread, so they are dropped.
+	if (!logger.running.load(std::memory_order_acquire))
+	{
+		return false;
+	}
+
+	u64 timestamp = read_timestamp();
+
+	u32 position;
+	LogRecord* record = claim_record(level, &position);
+	if (record == nullptr)
+	{
+		return false;
+	}
+
+	record->level = level;
+	record->binary = true;
+	record->length = (u16)args->size;
+	record->timestamp = timestamp;
+	record->format = format;
+	memcpy(record->message, args->data, args->size);
+	publish_record(record, position);
+	return true;
 }
\ No newline at end of file
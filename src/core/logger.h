@@ -1,12 +1,30 @@
 #pragma once
 
 #include "core/core_types.h"
+#include "core/logger_binary.h"
+
+#include <atomic>
 
 #define LOG_WARN_ENABLED  1
 #define LOG_INFO_ENABLED  1
 #define LOG_DEBUG_ENABLED 1
 #define LOG_TRACE_ENABLED 1
 
+// When enabled, INFO, DEBUG and TRACE messages are captured as binary records
+// (format pointer, timestamp and raw arguments) and written to LOG_BINARY_FILE_PATH
+// without being formatted. Decode the file with tools/log_decoder. Errors and
+// warnings are still formatted so they stay visible on the console.
+#define LOG_BINARY_ENABLED 0
+#define LOG_BINARY_FILE_PATH "d3d12_renderer.binlog"
+
+// Each LOG_* call site may log LOG_SITE_BURST messages per LOG_SITE_WINDOW_MS.
+// The rest are counted, and the logger thread reports them as one line naming
+// the site once the window ends, or sooner on a flush or shutdown. FATAL
+// messages are never limited.
+#define LOG_SITE_RATE_LIMIT_ENABLED 1
+#define LOG_SITE_BURST     8
+#define LOG_SITE_WINDOW_MS 1000
+
 enum class LogLevel : u8
 {
 	LOG_LEVEL_FATAL = 0,
@@ -17,35 +35,138 @@ enum class LogLevel : u8
 	LOG_LEVEL_TRACE = 5
 };
 
-bool initialize_logging();
-void shutdown_logging();
+enum class LogCategory : u8
+{
+	LOG_CATEGORY_GENERAL,
+	LOG_CATEGORY_RENDERER,
+	LOG_CATEGORY_INPUT,
+	LOG_CATEGORY_PLATFORM,
+	LOG_CATEGORY_ASSETS,
+	LOG_CATEGORY_MEMORY,
+	LOG_CATEGORY_MAX_CATEGORIES
+};
+
+// Bit n is set when LogLevel n is enabled for the category. The log macros test
+// this before evaluating any arguments. FATAL is always enabled.
+extern std::atomic<u8> log_category_masks[(u8)LogCategory::LOG_CATEGORY_MAX_CATEGORIES];
+
+inline bool log_enabled(LogCategory category, LogLevel level)
+{
+	return (log_category_masks[(u8)category].load(std::memory_order_relaxed) >> (u8)level) & 1;
+}
 
-void log_output(LogLevel level, const char* message, ...);
+// Rate limiting state for a single call site. Every LOG_* expansion owns one in a
+// function-local static. It's constant initialized without a guard, and threads
+// update it with atomics, so checking it takes no lock and no lookup.
+struct LogSite
+{
+	const char* file;
+	u32 line;
+	LogLevel level;
+	std::atomic<u64> window_start;
+	std::atomic<u32> window_count;
+	std::atomic<u32> suppressed_count;
+	// Set while the site waits on the logger thread to report its suppressed count.
+	std::atomic<bool> pending;
+	u64 pending_window; // window_start when the site was queued.
+	LogSite* next_pending;
+};
+
+bool log_site_allow(LogSite* site);
+
+// Enables every level up to and including max_level.
+void set_log_level(LogCategory category, LogLevel max_level);
+LogLevel get_log_level(LogCategory category);
+// Parses a comma separated list like "renderer=trace,input=warn,*=info".
+bool configure_log_levels(const char* config);
+
+struct LogConfig
+{
+	bool console_output;
+	// Text output is written into memory-mapped segments of file_segment_size bytes.
+	// When a segment fills up it is rotated to <path>.1, <path>.2 and so on, keeping
+	// max_file_segments in total. Set file_path to nullptr to disable file output.
+	const char* file_path;
+	u64 file_segment_size;
+	u32 max_file_segments;
+};
 
-#define LOG_FATAL(message, ...) log_output(LogLevel::LOG_LEVEL_FATAL, message, ##__VA_ARGS__);
+#define LOG_DEFAULT_FILE_PATH "d3d12_renderer.log"
 
-#define LOG_ERROR(message, ...) log_output(LogLevel::LOG_LEVEL_ERROR, message, ##__VA_ARGS__);
+// Messages are queued by the calling thread and written out by a background
+// logger thread. FATAL messages block until the queue has been flushed.
+// Passing nullptr uses the default config: console output and 4 x 4MB log files.
+// Timestamps come from read_timestamp, so call initialize_clock first.
+bool initialize_logging(const LogConfig* config = nullptr);
+// False when the logger thread didn't exit in time. It may still be touching
+// its queue, so the logging heap has to outlive the process.
+bool shutdown_logging();
+// Blocks until every message queued before the call has been written, along with
+// the counts of rate limited sites, or the timeout expires.
+bool flush_logging(u32 timeout_ms = 100);
+// Total number of messages dropped because the queue was full.
+u64 get_dropped_log_count();
+
+// Both return false when the message was dropped because the queue was full.
+bool log_output(LogLevel level, const char* message, ...);
+
+// The format must be a string literal, only its address is recorded.
+bool log_binary_output(LogLevel level, const char* format, const LogArgBuffer* args);
+
+template<typename... Args>
+inline bool log_binary(LogLevel level, const char* format, Args... args)
+{
+	LogArgBuffer buffer;
+	log_pack_args(&buffer, args...);
+	return log_binary_output(level, format, &buffer);
+}
+
+#if LOG_SITE_RATE_LIMIT_ENABLED
+#define LOG_IF_ENABLED(category, level, output) do { if (log_enabled(category, level)) { static LogSite log_site = { __FILE__, __LINE__, level, {}, {}, {}, {}, 0, nullptr }; if (log_site_allow(&log_site)) { output; } } } while (0)
+#else
+#define LOG_IF_ENABLED(category, level, output) do { if (log_enabled(category, level)) { output; } } while (0)
+#endif
+#define LOG_IF_ENABLED_UNLIMITED(category, level, output) do { if (log_enabled(category, level)) { output; } } while (0)
+
+#if LOG_BINARY_ENABLED
+#define LOG_DEFERRED_OUTPUT(level, message, ...) log_binary(level, "" message, ##__VA_ARGS__)
+#else
+#define LOG_DEFERRED_OUTPUT(level, message, ...) log_output(level, message, ##__VA_ARGS__)
+#endif
+
+// LOG_CAT_* take a category name without the prefix, e.g. LOG_CAT_INFO(RENDERER, "...").
+// The plain LOG_* macros log to the GENERAL category.
+#define LOG_CAT_FATAL(category, message, ...) LOG_IF_ENABLED_UNLIMITED(LogCategory::LOG_CATEGORY_##category, LogLevel::LOG_LEVEL_FATAL, log_output(LogLevel::LOG_LEVEL_FATAL, message, ##__VA_ARGS__))
+
+#define LOG_CAT_ERROR(category, message, ...) LOG_IF_ENABLED(LogCategory::LOG_CATEGORY_##category, LogLevel::LOG_LEVEL_ERROR, log_output(LogLevel::LOG_LEVEL_ERROR, message, ##__VA_ARGS__))
 
 #if LOG_WARN_ENABLED
-#define LOG_WARN(message, ...) log_output(LogLevel::LOG_LEVEL_WARN, message, ##__VA_ARGS__);
+#define LOG_CAT_WARN(category, message, ...) LOG_IF_ENABLED(LogCategory::LOG_CATEGORY_##category, LogLevel::LOG_LEVEL_WARN, log_output(LogLevel::LOG_LEVEL_WARN, message, ##__VA_ARGS__))
 #else
-#define LOG_WARN(message, ...)
+#define LOG_CAT_WARN(category, message, ...)
 #endif
 
 #if LOG_INFO_ENABLED
-#define LOG_INFO(message, ...) log_output(LogLevel::LOG_LEVEL_INFO, message, ##__VA_ARGS__);
+#define LOG_CAT_INFO(category, message, ...) LOG_IF_ENABLED(LogCategory::LOG_CATEGORY_##category, LogLevel::LOG_LEVEL_INFO, LOG_DEFERRED_OUTPUT(LogLevel::LOG_LEVEL_INFO, message, ##__VA_ARGS__))
 #else
-#define LOG_INFO(message, ...)
+#define LOG_CAT_INFO(category, message, ...)
 #endif
 
 #if LOG_DEBUG_ENABLED
-#define LOG_DEBUG(message, ...) log_output(LogLevel::LOG_LEVEL_DEBUG, message, ##__VA_ARGS__);
+#define LOG_CAT_DEBUG(category, message, ...) LOG_IF_ENABLED(LogCategory::LOG_CATEGORY_##category, LogLevel::LOG_LEVEL_DEBUG, LOG_DEFERRED_OUTPUT(LogLevel::LOG_LEVEL_DEBUG, message, ##__VA_ARGS__))
 #else
-#define LOG_DEBUG(message, ...)
+#define LOG_CAT_DEBUG(category, message, ...)
 #endif
 
 #if LOG_TRACE_ENABLED
-#define LOG_TRACE(message, ...) log_output(LogLevel::LOG_LEVEL_TRACE, message, ##__VA_ARGS__);
+#define LOG_CAT_TRACE(category, message, ...) LOG_IF_ENABLED(LogCategory::LOG_CATEGORY_##category, LogLevel::LOG_LEVEL_TRACE, LOG_DEFERRED_OUTPUT(LogLevel::LOG_LEVEL_TRACE, message, ##__VA_ARGS__))
 #else
-#define LOG_TRACE(message, ...)
-#endif
\ No newline at end of file
+#define LOG_CAT_TRACE(category, message, ...)
+#endif
+
+#define LOG_FATAL(message, ...) LOG_CAT_FATAL(GENERAL, message, ##__VA_ARGS__)
+#define LOG_ERROR(message, ...) LOG_CAT_ERROR(GENERAL, message, ##__VA_ARGS__)
+#define LOG_WARN(message, ...)  LOG_CAT_WARN(GENERAL, message, ##__VA_ARGS__)
+#define LOG_INFO(message, ...)  LOG_CAT_INFO(GENERAL, message, ##__VA_ARGS__)
+#define LOG_DEBUG(message, ...) LOG_CAT_DEBUG(GENERAL, message, ##__VA_ARGS__)
+#define LOG_TRACE(message, ...) LOG_CAT_TRACE(GENERAL, message, ##__VA_ARGS__)
\ No newline at end of file
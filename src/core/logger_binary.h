@@ -0,0 +1,136 @@
+#pragma once
+
+#include "core/core_types.h"
+
+#include <string.h>
+#include <type_traits>
+
+// Binary log records store the format string pointer, a timestamp and the raw
+// argument bytes. Formatting happens offline in tools/log_decoder.
+//
+// File layout:
+//   LogBinaryHeader
+//   A stream of records, each starting with a LogBinaryRecordKind byte:
+//     FORMAT: u64 format_id, u32 length, length bytes of format string.
+//             Written the first time a format string is seen.
+//     ENTRY:  u8 level, u64 timestamp, u64 format_id, u16 size, size bytes of arguments.
+//
+// Arguments are a sequence of LogArgType tags each followed by their payload.
+// Strings are stored as a u16 length followed by the characters.
+
+#define LOG_BINARY_MAGIC   0x474F4C42 // "BLOG"
+#define LOG_BINARY_VERSION 1
+
+struct LogBinaryHeader
+{
+	u32 magic;
+	u32 version;
+	u64 timestamp_frequency;
+	u64 start_timestamp;
+};
+
+enum class LogBinaryRecordKind : u8
+{
+	LOG_BINARY_RECORD_FORMAT = 1,
+	LOG_BINARY_RECORD_ENTRY  = 2
+};
+
+enum class LogArgType : u8
+{
+	LOG_ARG_S32,
+	LOG_ARG_U32,
+	LOG_ARG_S64,
+	LOG_ARG_U64,
+	LOG_ARG_F64,
+	LOG_ARG_STRING,
+	LOG_ARG_POINTER
+};
+
+// Enough for a dozen numeric arguments or a couple of short strings. The first
+// argument that doesn't fit and everything after it are dropped from the record,
+// the decoder prints them as missing.
+#define LOG_BINARY_ARGS_SIZE 256
+
+struct LogArgBuffer
+{
+	u32 size; // Ends at the last complete argument.
+	bool truncated;
+	u8 data[LOG_BINARY_ARGS_SIZE];
+};
+
+inline void log_pack_bytes(LogArgBuffer* buffer, LogArgType type, const void* value, u32 size)
+{
+	if (buffer->truncated || buffer->size + 1 + size > LOG_BINARY_ARGS_SIZE)
+	{
+		buffer->truncated = true;
+		return;
+	}
+
+	buffer->data[buffer->size] = (u8)type;
+	memcpy(buffer->data + buffer->size + 1, value, size);
+	buffer->size += 1 + size;
+}
+
+inline void log_pack_string(LogArgBuffer* buffer, const char* value)
+{
+	if (value == nullptr)
+	{
+		value = "(null)";
+	}
+
+	u32 available = LOG_BINARY_ARGS_SIZE - buffer->size;
+	if (buffer->truncated || available < 1 + sizeof(u16))
+	{
+		buffer->truncated = true;
+		return;
+	}
+
+	u16 length = (u16)strnlen(value, available - 1 - sizeof(u16));
+	buffer->data[buffer->size] = (u8)LogArgType::LOG_ARG_STRING;
+	memcpy(buffer->data + buffer->size + 1, &length, sizeof(u16));
+	memcpy(buffer->data + buffer->size + 1 + sizeof(u16), value, length);
+	buffer->size += 1 + sizeof(u16) + length;
+}
+
+template<typename T>
+inline void log_pack_arg(LogArgBuffer* buffer, T value)
+{
+	if constexpr (std::is_same<T, const char*>::value || std::is_same<T, char*>::value)
+	{
+		log_pack_string(buffer, value);
+	}
+	else if constexpr (std::is_pointer<T>::value)
+	{
+		u64 address = (u64)(const void*)value;
+		log_pack_bytes(buffer, LogArgType::LOG_ARG_POINTER, &address, sizeof(address));
+	}
+	else if constexpr (std::is_floating_point<T>::value)
+	{
+		f64 number = (f64)value;
+		log_pack_bytes(buffer, LogArgType::LOG_ARG_F64, &number, sizeof(number));
+	}
+	else if constexpr (std::is_integral<T>::value && sizeof(T) > 4)
+	{
+		u64 number = (u64)value;
+		log_pack_bytes(buffer, std::is_signed<T>::value ? LogArgType::LOG_ARG_S64 : LogArgType::LOG_ARG_U64, &number, sizeof(number));
+	}
+	else if constexpr (std::is_integral<T>::value)
+	{
+		// Small integers are promoted the same way varargs would promote them.
+		u32 number = std::is_signed<T>::value ? (u32)(s32)value : (u32)value;
+		log_pack_bytes(buffer, (std::is_signed<T>::value || sizeof(T) < 4) ? LogArgType::LOG_ARG_S32 : LogArgType::LOG_ARG_U32, &number, sizeof(number));
+	}
+	else
+	{
+		static_assert(std::is_integral<T>::value, "Unsupported binary log argument type. Cast enums to an integer.");
+	}
+}
+
+// Template args decay arrays, so char buffers arrive here as char*.
+template<typename... Args>
+inline void log_pack_args(LogArgBuffer* buffer, Args... args)
+{
+	buffer->size = 0;
+	buffer->truncated = false;
+	(log_pack_arg(buffer, args), ...);
+}
\ No newline at end of file
@@ -0,0 +1,254 @@
+#include "core/memory_tracking.h"
+#include "core/platform/platform.h"
+
+#include <stdio.h>
+#include <string.h>
+
+struct MemoryCounter
+{
+	std::atomic<s64> bytes;
+	std::atomic<s64> count;
+	std::atomic<s64> high_water;
+	std::atomic<u64> allocations;
+};
+
+struct MemoryThreadStats
+{
+	MemoryCounter tags[(u8)MemoryTag::MEMORY_TAG_MAX];
+	MemoryCounter sites[MEMORY_MAX_SITES];
+};
+
+struct MemoryTracker
+{
+	// Id 0 is MEMORY_SITE_NONE and stays empty.
+	MemorySite* sites[MEMORY_MAX_SITES];
+	std::atomic<u32> site_count;
+	std::atomic<bool> sites_locked;
+
+	std::atomic<u32> thread_count;
+	MemoryThreadStats threads[MEMORY_MAX_THREADS];
+};
+
+static MemoryTracker tracker;
+
+static thread_local MemoryThreadStats* current_thread_stats = nullptr;
+
+static const char* tag_names[(u8)MemoryTag::MEMORY_TAG_MAX] = { "untagged", "renderer", "assets", "logging", "frame", "scratch" };
+
+MemorySiteId register_memory_site(MemorySite* site)
+{
+	MemorySiteId id = site->id.load(std::memory_order_acquire);
+	if (id != MEMORY_SITE_NONE)
+	{
+		return id;
+	}
+
+	while (tracker.sites_locked.exchange(true, std::memory_order_acquire))
+	{
+		yield_thread();
+	}
+
+	// Another thread may have registered it while this one waited.
+	id = site->id.load(std::memory_order_relaxed);
+	u32 site_count = tracker.site_count.load(std::memory_order_relaxed);
+	if (site_count == 0)
+	{
+		site_count = MEMORY_SITE_NONE + 1;
+	}
+	if (id == MEMORY_SITE_NONE && site_count < MEMORY_MAX_SITES)
+	{
+		id = (MemorySiteId)site_count;
+		tracker.sites[id] = site;
+		tracker.site_count.store(site_count + 1, std::memory_order_release);
+		site->id.store(id, std::memory_order_release);
+	}
+
+	tracker.sites_locked.store(false, std::memory_order_release);
+	return id;
+}
+
+static MemoryThreadStats* get_thread_stats(bool* shared)
+{
+	if (current_thread_stats == nullptr)
+	{
+		u32 index = tracker.thread_count.fetch_add(1, std::memory_order_relaxed);
+		current_thread_stats = &tracker.threads[index < MEMORY_MAX_THREADS ? index : MEMORY_MAX_THREADS - 1];
+	}
+	*shared = current_thread_stats == &tracker.threads[MEMORY_MAX_THREADS - 1];
+	return current_thread_stats;
+}
+
+static void update_counter(MemoryCounter* counter, s64 bytes, s64 count, bool shared)
+{
+	if (!shared)
+	{
+		// Only this thread writes the counter, so there's no need for a locked add.
+		s64 new_bytes = counter->bytes.load(std::memory_order_relaxed) + bytes;
+		counter->bytes.store(new_bytes, std::memory_order_relaxed);
+		counter->count.store(counter->count.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+		if (count > 0)
+		{
+			counter->allocations.store(counter->allocations.load(std::memory_order_relaxed) + (u64)count, std::memory_order_relaxed);
+		}
+		if (new_bytes > counter->high_water.load(std::memory_order_relaxed))
+		{
+			counter->high_water.store(new_bytes, std::memory_order_relaxed);
+		}
+		return;
+	}
+
+	s64 new_bytes = counter->bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+	counter->count.fetch_add(count, std::memory_order_relaxed);
+	if (count > 0)
+	{
+		counter->allocations.fetch_add((u64)count, std::memory_order_relaxed);
+	}
+	s64 high_water = counter->high_water.load(std::memory_order_relaxed);
+	while (new_bytes > high_water && !counter->high_water.compare_exchange_weak(high_water, new_bytes, std::memory_order_relaxed))
+	{
+	}
+}
+
+void track_memory(MemorySiteId site, s64 bytes, s64 count)
+{
+	bool shared;
+	MemoryThreadStats* stats = get_thread_stats(&shared);
+
+	MemoryTag tag = site != MEMORY_SITE_NONE ? tracker.sites[site]->tag : MemoryTag::MEMORY_TAG_UNTAGGED;
+	update_counter(&stats->tags[(u8)tag], bytes, count, shared);
+	update_counter(&stats->sites[site], bytes, count, shared);
+}
+
+static void add_counter(MemoryStats* stats, const MemoryCounter* counter)
+{
+	stats->bytes += counter->bytes.load(std::memory_order_relaxed);
+	stats->count += counter->count.load(std::memory_order_relaxed);
+	stats->high_water += counter->high_water.load(std::memory_order_relaxed);
+	stats->allocations += counter->allocations.load(std::memory_order_relaxed);
+}
+
+void take_memory_snapshot(MemorySnapshot* snapshot)
+{
+	memset(snapshot, 0, sizeof(*snapshot));
+	snapshot->timestamp = read_timestamp();
+	snapshot->site_count = tracker.site_count.load(std::memory_order_acquire);
+
+	u32 thread_count = tracker.thread_count.load(std::memory_order_relaxed);
+	if (thread_count > MEMORY_MAX_THREADS)
+	{
+		thread_count = MEMORY_MAX_THREADS;
+	}
+
+	for (u32 thread = 0; thread < thread_count; ++thread)
+	{
+		const MemoryThreadStats* stats = &tracker.threads[thread];
+		for (u8 tag = 0; tag < (u8)MemoryTag::MEMORY_TAG_MAX; ++tag)
+		{
+			add_counter(&snapshot->tags[tag], &stats->tags[tag]);
+			add_counter(&snapshot->total, &stats->tags[tag]);
+		}
+		for (u32 site = 0; site < snapshot->site_count; ++site)
+		{
+			add_counter(&snapshot->sites[site], &stats->sites[site]);
+		}
+	}
+}
+
+static void diff_stats(const MemoryStats* before, const MemoryStats* after, MemoryStats* diff)
+{
+	diff->bytes = after->bytes - before->bytes;
+	diff->count = after->count - before->count;
+	diff->high_water = after->high_water;
+	diff->allocations = after->allocations - before->allocations;
+}
+
+void diff_memory_snapshots(const MemorySnapshot* before, const MemorySnapshot* after, MemorySnapshot* diff)
+{
+	// after may be the same snapshot as diff, so finish reading it per entry first.
+	diff->timestamp = after->timestamp;
+	diff->site_count = after->site_count;
+	diff_stats(&before->total, &after->total, &diff->total);
+	for (u8 tag = 0; tag < (u8)MemoryTag::MEMORY_TAG_MAX; ++tag)
+	{
+		diff_stats(&before->tags[tag], &after->tags[tag], &diff->tags[tag]);
+	}
+	// Sites registered after before was taken started from zero.
+	for (u32 site = 0; site < after->site_count; ++site)
+	{
+		MemoryStats empty = {};
+		diff_stats(site < before->site_count ? &before->sites[site] : &empty, &after->sites[site], &diff->sites[site]);
+	}
+}
+
+bool write_memory_snapshot(const char* path, const MemorySnapshot* snapshot)
+{
+	FILE* file = fopen(path, "w");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	fprintf(file, "%-40s %14s %10s %14s %12s\n", "tag", "bytes", "count", "high water", "allocations");
+	fprintf(file, "%-40s %14lld %10lld %14lld %12llu\n", "total", snapshot->total.bytes, snapshot->total.count, snapshot->total.high_water, snapshot->total.allocations);
+	for (u8 tag = 0; tag < (u8)MemoryTag::MEMORY_TAG_MAX; ++tag)
+	{
+		const MemoryStats* stats = &snapshot->tags[tag];
+		fprintf(file, "%-40s %14lld %10lld %14lld %12llu\n", tag_names[tag], stats->bytes, stats->count, stats->high_water, stats->allocations);
+	}
+
+	// Insertion sort is plenty for a few hundred sites.
+	u16 order[MEMORY_MAX_SITES];
+	u32 order_count = 0;
+	for (u32 site = 0; site < snapshot->site_count; ++site)
+	{
+		const MemoryStats* stats = &snapshot->sites[site];
+		if (stats->bytes == 0 && stats->count == 0 && stats->allocations == 0)
+		{
+			continue;
+		}
+
+		u32 i = order_count++;
+		while (i > 0 && snapshot->sites[order[i - 1]].bytes < stats->bytes)
+		{
+			order[i] = order[i - 1];
+			i--;
+		}
+		order[i] = (u16)site;
+	}
+
+	fprintf(file, "\n%-40s %-10s %14s %10s %14s %12s\n", "site", "tag", "bytes", "count", "high water", "allocations");
+	for (u32 i = 0; i < order_count; ++i)
+	{
+		const MemoryStats* stats = &snapshot->sites[order[i]];
+		const MemorySite* site = get_memory_site(order[i]);
+
+		char location[256];
+		if (site)
+		{
+			snprintf(location, sizeof(location), "%s:%u", site->file, site->line);
+		}
+		else
+		{
+			snprintf(location, sizeof(location), "unknown");
+		}
+		const char* tag_name = site ? tag_names[(u8)site->tag] : tag_names[(u8)MemoryTag::MEMORY_TAG_UNTAGGED];
+		fprintf(file, "%-40s %-10s %14lld %10lld %14lld %12llu\n", location, tag_name, stats->bytes, stats->count, stats->high_water, stats->allocations);
+	}
+
+	fclose(file);
+	return true;
+}
+
+const char* get_memory_tag_name(MemoryTag tag)
+{
+	return tag_names[(u8)tag];
+}
+
+const MemorySite* get_memory_site(MemorySiteId site)
+{
+	if (site == MEMORY_SITE_NONE || site >= tracker.site_count.load(std::memory_order_acquire))
+	{
+		return nullptr;
+	}
+	return tracker.sites[site];
+}
\ No newline at end of file
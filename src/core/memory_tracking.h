@@ -0,0 +1,80 @@
+#pragma once
+
+#include "core/core_types.h"
+
+#include <atomic>
+
+// Every engine allocation names the call site it came from, and each site
+// belongs to one subsystem tag. Counters live per thread so recording an
+// allocation is a few plain stores, snapshots sum them across threads.
+#define MEMORY_TRACKING_ENABLED 1
+// Sites past this are counted under MEMORY_SITE_NONE.
+#define MEMORY_MAX_SITES 256
+// Threads past the first MEMORY_MAX_THREADS - 1 share the last slot, which is
+// updated atomically.
+#define MEMORY_MAX_THREADS 64
+#define MEMORY_DUMP_DEFAULT_PATH "d3d12_renderer_memory.txt"
+
+enum class MemoryTag : u8
+{
+	MEMORY_TAG_UNTAGGED,
+	MEMORY_TAG_RENDERER,
+	MEMORY_TAG_ASSETS,
+	MEMORY_TAG_LOGGING,
+	MEMORY_TAG_FRAME,
+	MEMORY_TAG_SCRATCH,
+	MEMORY_TAG_MAX
+};
+
+typedef u16 MemorySiteId;
+#define MEMORY_SITE_NONE 0
+
+// One per MEMORY_SITE expansion. The id is handed out on first use.
+struct MemorySite
+{
+	const char* file;
+	u32 line;
+	MemoryTag tag;
+	std::atomic<MemorySiteId> id;
+};
+
+MemorySiteId register_memory_site(MemorySite* site);
+
+#if MEMORY_TRACKING_ENABLED
+#define MEMORY_SITE(tag) ([]() { static MemorySite memory_site = { __FILE__, __LINE__, MemoryTag::MEMORY_TAG_##tag, {} }; return register_memory_site(&memory_site); }())
+#else
+#define MEMORY_SITE(tag) ((MemorySiteId)MEMORY_SITE_NONE)
+#endif
+
+// Adds bytes and live allocations to a site on the calling thread. Frees pass
+// negative values. A positive count also adds to the total allocation count.
+void track_memory(MemorySiteId site, s64 bytes, s64 count);
+
+struct MemoryStats
+{
+	s64 bytes;
+	s64 count;
+	// Sum of each thread's peak. Memory freed on another thread than the one that
+	// allocated it can push this past the true peak, but never below it.
+	s64 high_water;
+	u64 allocations; // Ever made, for spotting churn.
+};
+
+struct MemorySnapshot
+{
+	u64 timestamp; // read_timestamp() when taken.
+	u32 site_count;
+	MemoryStats total;
+	MemoryStats tags[(u8)MemoryTag::MEMORY_TAG_MAX];
+	MemoryStats sites[MEMORY_MAX_SITES];
+};
+
+void take_memory_snapshot(MemorySnapshot* snapshot);
+// What changed from before to after. High-water marks are taken from after.
+void diff_memory_snapshots(const MemorySnapshot* before, const MemorySnapshot* after, MemorySnapshot* diff);
+// Writes the totals, then every site with live or changed allocations, largest first.
+bool write_memory_snapshot(const char* path, const MemorySnapshot* snapshot);
+
+const char* get_memory_tag_name(MemoryTag tag);
+// nullptr for MEMORY_SITE_NONE or an unused id.
+const MemorySite* get_memory_site(MemorySiteId site);
\ No newline at end of file
@@ -1,3 +1,287 @@
 #pragma once
 
-void* copy_memory(void* dest, const void* src, size_t size);
\ No newline at end of file
+#include "core/core_types.h"
+
+#include <stddef.h>
+
+// Memory.
+// Each implementation provides every memory function below. The best one the CPU
+// supports is picked once by initialize_memory_functions, call it before starting
+// any threads. Until then the libc versions are used.
+enum class MemoryImplementation : u8
+{
+	MEMORY_IMPLEMENTATION_LIBC,
+	MEMORY_IMPLEMENTATION_SSE2,
+	MEMORY_IMPLEMENTATION_AVX2,
+	MEMORY_IMPLEMENTATION_AVX512,
+	MEMORY_IMPLEMENTATION_NEON,
+	MEMORY_IMPLEMENTATION_MAX_IMPLEMENTATIONS
+};
+
+void initialize_memory_functions();
+bool is_memory_implementation_supported(MemoryImplementation implementation);
+// Returns false if the CPU doesn't support it. Used by benchmarks to compare implementations.
+bool select_memory_implementation(MemoryImplementation implementation);
+MemoryImplementation get_memory_implementation();
+const char* get_memory_implementation_name(MemoryImplementation implementation);
+
+// Same contracts as memcpy, memset and memcmp.
+void* copy_memory(void* dest, const void* src, size_t size);
+void* set_memory(void* dest, u8 value, size_t size);
+s32 compare_memory(const void* a, const void* b, size_t size);
+// Copies with non-temporal stores that bypass the cache. Use it for large writes
+// the CPU won't read back, like filling upload heaps, which are write-combined.
+void* stream_copy_memory(void* dest, const void* src, size_t size);
+
+// Virtual memory.
+// Reserving only claims address space, pages cost nothing until they are
+// committed. Sizes and addresses passed to commit and decommit are rounded out
+// to whole pages.
+u64 get_page_size();
+// 0 if the OS doesn't expose large pages.
+u64 get_large_page_size();
+// Returns nullptr on failure. With large_pages the reservation is backed by
+// large pages where the OS allows it. On Windows that commits the whole range up
+// front (and needs the "Lock pages in memory" privilege), on Linux it asks for
+// transparent huge pages and pages are still committed on demand.
+void* reserve_memory(u64 size, bool large_pages);
+bool commit_memory(void* address, u64 size);
+// Returns the pages to the OS, the address range stays reserved.
+void decommit_memory(void* address, u64 size);
+// size must be the size passed to reserve_memory.
+void release_memory(void* address, u64 size);
+
+// Timing.
+// The OS clock, QueryPerformanceCounter or CLOCK_MONOTONIC.
+u64 get_performance_counter();
+// Ticks per second of get_performance_counter.
+u64 get_performance_frequency();
+
+// The calibrated clock. Timestamps come from the invariant TSC when the CPU has
+// one, which is a single rdtsc, and from the OS clock otherwise. Call
+// initialize_clock once at startup before anything reads timestamps.
+void initialize_clock();
+bool is_clock_using_tsc();
+u64 read_timestamp();
+// Ticks per second of read_timestamp.
+u64 get_timestamp_frequency();
+// Ticks elapsed since a read_timestamp value. These are TSC (reference) cycles
+// when is_clock_using_tsc, not core clock cycles.
+u64 cycles_since(u64 start);
+u64 timestamp_to_ns(u64 ticks);
+// Signed so deltas between timestamps read on different threads can be passed directly.
+f64 timestamp_to_ms(s64 ticks);
+// Monotonic nanoseconds since initialize_clock.
+u64 get_time_ns();
+
+// Threads.
+typedef u32 (*ThreadProc)(void* data);
+
+// The thread keeps a pointer to this struct until it exits, so it must outlive the thread.
+struct PlatformThread
+{
+	void* handle;
+	ThreadProc proc;
+	void* data;
+	u32 id; // OS thread id, valid once create_thread returns.
+};
+
+// Linux asks for CAP_SYS_NICE (or a raised RLIMIT_NICE) for anything above
+// normal, without it set_thread_priority fails and the thread keeps its priority.
+enum class ThreadPriority : u8
+{
+	THREAD_PRIORITY_CLASS_BACKGROUND,
+	THREAD_PRIORITY_CLASS_LOW,
+	THREAD_PRIORITY_CLASS_NORMAL,
+	THREAD_PRIORITY_CLASS_HIGH,
+	THREAD_PRIORITY_CLASS_CRITICAL
+};
+
+// name shows up in debuggers and profilers. Linux truncates it to 15 characters.
+bool create_thread(PlatformThread* thread, ThreadProc proc, void* data, const char* name = nullptr);
+// Returns false if the thread did not exit within timeout_ms.
+bool join_thread(PlatformThread* thread, u32 timeout_ms);
+void yield_thread();
+
+// These take nullptr for the calling thread. Processor masks have one bit per
+// logical processor, so only the first 64 (processor group 0 on Windows) can be used.
+void set_thread_name(PlatformThread* thread, const char* name);
+bool set_thread_affinity(PlatformThread* thread, u64 processor_mask);
+bool set_thread_priority(PlatformThread* thread, ThreadPriority priority);
+// Logical processor the calling thread is running on right now.
+u32 get_current_processor();
+
+// CPU topology.
+#define CPU_MAX_LOGICAL_PROCESSORS 64
+#define CPU_MAX_CACHE_DOMAINS 16
+
+struct CpuCore
+{
+	u64 processor_mask; // Its SMT siblings, one bit per logical processor.
+	u32 cache_domain;   // Index into CpuTopology::cache_domains.
+	u8 efficiency_class; // Higher is faster on hybrid CPUs, 0 everywhere else.
+};
+
+// Logical processors sharing a last level cache, a CCX on AMD parts. Threads
+// that share data should stay inside one.
+struct CpuCacheDomain
+{
+	u64 processor_mask;
+	u32 size;
+};
+
+struct CpuTopology
+{
+	u32 logical_processor_count;
+	u32 core_count;
+	u32 cache_domain_count;
+	u32 cache_line_size;
+	u32 l1_data_size; // Per core.
+	u32 l2_size;      // Per core.
+	CpuCore cores[CPU_MAX_LOGICAL_PROCESSORS];
+	CpuCacheDomain cache_domains[CPU_MAX_CACHE_DOMAINS];
+};
+
+// Processors past CPU_MAX_LOGICAL_PROCESSORS are left out. Returns false if the
+// OS couldn't be queried, topology then describes one core per logical processor.
+bool get_cpu_topology(CpuTopology* topology);
+
+// Auto-reset event used to wake a sleeping thread.
+struct PlatformEvent
+{
+	void* handle;
+};
+
+bool create_event(PlatformEvent* event);
+void destroy_event(PlatformEvent* event);
+void signal_event(PlatformEvent* event);
+// Returns false if the event was not signaled within timeout_ms.
+bool wait_for_event(PlatformEvent* event, u32 timeout_ms);
+
+// Console output.
+enum class ConsoleColor : u8
+{
+	CONSOLE_COLOR_RED_BACKGROUND,
+	CONSOLE_COLOR_RED,
+	CONSOLE_COLOR_YELLOW,
+	CONSOLE_COLOR_GREEN,
+	CONSOLE_COLOR_BLUE,
+	CONSOLE_COLOR_GREY
+};
+
+void write_console(const char* message, u64 length, ConsoleColor color);
+// Message must be null terminated.
+void write_debug_output(const char* message);
+
+// Memory-mapped files.
+struct PlatformMappedFile
+{
+	void* file_handle;
+	void* mapping_handle;
+	u8* data;
+	u64 size;
+};
+
+// Creates or truncates the file, sizes it to size bytes and maps it for writing.
+// Writes to the mapping reach the OS page cache immediately, so they survive the
+// process crashing without having to flush each one.
+bool create_mapped_file(PlatformMappedFile* file, const char* path, u64 size);
+// Unmaps the file and truncates it to used_size bytes.
+void close_mapped_file(PlatformMappedFile* file, u64 used_size);
+
+// How a read-only mapping is going to be read, so the OS can tune read-ahead.
+enum class MappedFileAccess : u8
+{
+	MAPPED_FILE_ACCESS_NORMAL,
+	MAPPED_FILE_ACCESS_SEQUENTIAL,
+	MAPPED_FILE_ACCESS_RANDOM
+};
+
+// Maps an existing file read-only. The view shares pages with the OS file cache,
+// so data can be used in place without copying it. Empty files can't be mapped.
+// huge_pages asks Linux to back the view with transparent huge pages where the
+// file system supports it, Windows can't map files with large pages and ignores it.
+bool open_mapped_file(PlatformMappedFile* file, const char* path, MappedFileAccess access = MappedFileAccess::MAPPED_FILE_ACCESS_NORMAL, bool huge_pages = false);
+// Unmaps a file opened with open_mapped_file.
+void unmap_file(PlatformMappedFile* file);
+// Starts reading the range into memory in the background, so first touches don't
+// stall on page faults.
+void prefetch_mapped_file(PlatformMappedFile* file, u64 offset, u64 size);
+
+// Files.
+// Returns false if the file doesn't exist or can't be read.
+bool get_file_size(const char* path, u64* size);
+// Reads up to buffer_size bytes from the start of the file.
+bool read_file(const char* path, void* buffer, u64 buffer_size, u64* bytes_read);
+// Creates or truncates the file.
+bool write_file(const char* path, const void* data, u64 size);
+
+// Asynchronous file reads.
+// Reads are queued with submit_async_reads, which sends the whole batch to the
+// OS at once (io_uring on Linux, overlapped I/O on a completion port on Windows).
+// Completions are only picked up by poll_async_reads and wait_for_async_read,
+// so callbacks run on whichever thread calls those. The API is not thread safe,
+// one thread owns the queue.
+#define ASYNC_IO_DEFAULT_QUEUE_DEPTH 64
+// Reads still in flight after this are abandoned at shutdown. The OS may still
+// write into their buffers, so the queue is leaked rather than released.
+#define ASYNC_IO_SHUTDOWN_TIMEOUT_MS 5000
+
+enum class AsyncReadStatus : u8
+{
+	ASYNC_READ_STATUS_IDLE,
+	ASYNC_READ_STATUS_PENDING,
+	ASYNC_READ_STATUS_COMPLETE,
+	ASYNC_READ_STATUS_FAILED
+};
+
+struct AsyncFileRead;
+typedef void (*AsyncReadCallback)(AsyncFileRead* read);
+
+// Must stay in place until the read completes.
+struct AsyncFileRead
+{
+	// Set by the caller.
+	const char* path;
+	void* buffer;
+	u64 buffer_size; // Reads up to this many bytes, fewer at the end of the file.
+	u64 offset;
+	AsyncReadCallback callback; // Optional.
+	void* user_data;
+
+	// Set by the platform.
+	AsyncReadStatus status;
+	u64 bytes_read;
+	u32 slot;
+};
+
+// queue_depth is how many reads can be in flight at once.
+bool initialize_async_io(u32 queue_depth = ASYNC_IO_DEFAULT_QUEUE_DEPTH);
+void shutdown_async_io();
+// Returns how many reads were submitted, reads past the queue depth are left idle.
+// Reads whose file can't be opened fail (and call back) right away.
+u32 submit_async_reads(AsyncFileRead* reads, u32 count);
+// Finishes any completed reads without blocking. Returns how many finished.
+u32 poll_async_reads();
+// Finishes completed reads until read is done. Returns false if it failed or
+// didn't finish within timeout_ms.
+bool wait_for_async_read(AsyncFileRead* read, u32 timeout_ms);
+
+// Windows.
+// On platforms without a window system the window is headless, it has no
+// handle and its title goes to the console instead.
+struct PlatformWindow
+{
+	void* handle;
+	u32 client_width;
+	u32 client_height;
+};
+
+bool create_window(PlatformWindow* window, const char* title, u32 pos_x, u32 pos_y, u32 client_width, u32 client_height);
+void destroy_window(PlatformWindow* window);
+void set_window_title(PlatformWindow* window, const char* title);
+// The current size of the client area, which may differ from the size it was created with.
+void get_window_client_size(PlatformWindow* window, u32* width, u32* height);
+// Dispatches pending OS messages, forwarding input to the input system. Returns
+// false once the application has been asked to quit.
+bool pump_messages();
\ No newline at end of file
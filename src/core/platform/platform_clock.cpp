@@ -0,0 +1,162 @@
+#include "core/platform/platform.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define CLOCK_X64 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+#endif
+
+// How long to measure the TSC against the OS clock when CPUID doesn't report its
+// frequency. Longer is more accurate, 20ms is within a few ppm of the OS clock.
+#define CLOCK_CALIBRATION_MS 20
+
+struct Clock
+{
+	bool use_tsc;
+	u64 frequency;
+	u64 start;
+	// Ticks to nanoseconds as a 32.32 fixed point multiplier.
+	u64 ns_per_tick;
+};
+
+static Clock timestamp_clock = {};
+
+#if CLOCK_X64
+static void clock_cpuid(u32 leaf, u32 subleaf, u32 registers[4])
+{
+#if defined(_MSC_VER)
+	__cpuidex((int*)registers, (int)leaf, (int)subleaf);
+#else
+	__cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+}
+
+// An invariant TSC runs at a constant rate in every P-, C- and T-state and is
+// synchronized between cores, so it can be compared across threads.
+static bool has_invariant_tsc()
+{
+	u32 registers[4];
+	clock_cpuid(0x80000000, 0, registers);
+	if (registers[0] < 0x80000007)
+	{
+		return false;
+	}
+
+	clock_cpuid(0x80000007, 0, registers);
+	return (registers[3] & (1u << 8)) != 0;
+}
+
+// Leaf 0x15 gives the TSC to crystal ratio and, on newer CPUs, the crystal frequency.
+static u64 get_cpuid_tsc_frequency()
+{
+	u32 registers[4];
+	clock_cpuid(0, 0, registers);
+	if (registers[0] < 0x15)
+	{
+		return 0;
+	}
+
+	clock_cpuid(0x15, 0, registers);
+	if (registers[0] == 0 || registers[1] == 0 || registers[2] == 0)
+	{
+		return 0;
+	}
+	return (u64)registers[2] * registers[1] / registers[0];
+}
+
+static u64 calibrate_tsc_frequency()
+{
+	u64 os_frequency = get_performance_frequency();
+	u64 os_ticks = os_frequency * CLOCK_CALIBRATION_MS / 1000;
+
+	u64 os_start = get_performance_counter();
+	u64 tsc_start = __rdtsc();
+	u64 os_end;
+	do
+	{
+		os_end = get_performance_counter();
+	} while (os_end - os_start < os_ticks);
+	u64 tsc_end = __rdtsc();
+
+	return (u64)((f64)(tsc_end - tsc_start) * (f64)os_frequency / (f64)(os_end - os_start));
+}
+#endif
+
+void initialize_clock()
+{
+	timestamp_clock = {};
+	timestamp_clock.frequency = get_performance_frequency();
+
+#if CLOCK_X64
+	if (has_invariant_tsc())
+	{
+		u64 frequency = get_cpuid_tsc_frequency();
+		if (frequency == 0)
+		{
+			frequency = calibrate_tsc_frequency();
+		}
+
+		if (frequency != 0)
+		{
+			timestamp_clock.use_tsc = true;
+			timestamp_clock.frequency = frequency;
+		}
+	}
+#endif
+
+	timestamp_clock.ns_per_tick = (1000000000ull << 32) / timestamp_clock.frequency;
+	timestamp_clock.start = read_timestamp();
+}
+
+bool is_clock_using_tsc()
+{
+	return timestamp_clock.use_tsc;
+}
+
+u64 read_timestamp()
+{
+#if CLOCK_X64
+	if (timestamp_clock.use_tsc)
+	{
+		return __rdtsc();
+	}
+#endif
+	return get_performance_counter();
+}
+
+u64 get_timestamp_frequency()
+{
+	return timestamp_clock.frequency;
+}
+
+u64 cycles_since(u64 start)
+{
+	return read_timestamp() - start;
+}
+
+u64 timestamp_to_ns(u64 ticks)
+{
+	// A full 64x64 multiply done in 32-bit halves, keeping bits 32-95 of the
+	// product. No partial product can overflow, so it's exact for any clock from
+	// 1Hz (the 10MHz QPC included) to over 1THz, until the result itself passes
+	// 64 bits of nanoseconds (584 years).
+	u64 ticks_high = ticks >> 32;
+	u64 ticks_low = ticks & 0xFFFFFFFFull;
+	u64 scale_high = timestamp_clock.ns_per_tick >> 32;
+	u64 scale_low = timestamp_clock.ns_per_tick & 0xFFFFFFFFull;
+	return ((ticks_high * scale_high) << 32) + ticks_high * scale_low + ticks_low * scale_high + ((ticks_low * scale_low) >> 32);
+}
+
+f64 timestamp_to_ms(s64 ticks)
+{
+	return (f64)ticks * 1000.0 / (f64)timestamp_clock.frequency;
+}
+
+u64 get_time_ns()
+{
+	return timestamp_to_ns(read_timestamp() - timestamp_clock.start);
+}
\ No newline at end of file
@@ -0,0 +1,710 @@
+#include "core/platform/platform.h"
+#include "core/intrinsics.h"
+
+#include <string.h>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define MEMORY_X64 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+// MSVC allows any intrinsic in any function.
+#define TARGET_AVX2
+#define TARGET_AVX512
+#else
+#include <cpuid.h>
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_AVX512 __attribute__((target("avx512f,avx512bw")))
+#endif
+#elif defined(_M_ARM64) || defined(__aarch64__)
+#define MEMORY_NEON 1
+#include <arm_neon.h>
+#endif
+
+// Below these sizes the call overhead and tail handling outweigh the wide loops,
+// so the SIMD versions hand off to libc or the regular copy.
+#define SIMD_MEMORY_MIN_SIZE 64
+#define STREAM_COPY_MIN_SIZE 256
+
+typedef void* (*CopyMemoryProc)(void* dest, const void* src, size_t size);
+typedef void* (*SetMemoryProc)(void* dest, u8 value, size_t size);
+typedef s32 (*CompareMemoryProc)(const void* a, const void* b, size_t size);
+
+struct MemoryFunctions
+{
+	CopyMemoryProc copy;
+	SetMemoryProc set;
+	CompareMemoryProc compare;
+	CopyMemoryProc stream_copy;
+};
+
+// libc.
+static void* copy_memory_libc(void* dest, const void* src, size_t size)
+{
+	return memcpy(dest, src, size);
+}
+
+static void* set_memory_libc(void* dest, u8 value, size_t size)
+{
+	return memset(dest, value, size);
+}
+
+static s32 compare_memory_libc(const void* a, const void* b, size_t size)
+{
+	return memcmp(a, b, size);
+}
+
+static s32 compare_bytes_at(const u8* a, const u8* b, u32 index)
+{
+	return (s32)a[index] - (s32)b[index];
+}
+
+#if MEMORY_X64
+// SSE2 is part of x64, so this is the baseline.
+static void* copy_memory_sse2(void* dest, const void* src, size_t size)
+{
+	if (size < SIMD_MEMORY_MIN_SIZE)
+	{
+		return memcpy(dest, src, size);
+	}
+
+	u8* d = (u8*)dest;
+	const u8* s = (const u8*)src;
+	const u8* end = s + size;
+	u8* dest_end = d + size;
+	for (; size >= 64; size -= 64, d += 64, s += 64)
+	{
+		__m128i a = _mm_loadu_si128((const __m128i*)(s + 0));
+		__m128i b = _mm_loadu_si128((const __m128i*)(s + 16));
+		__m128i c = _mm_loadu_si128((const __m128i*)(s + 32));
+		__m128i e = _mm_loadu_si128((const __m128i*)(s + 48));
+		_mm_storeu_si128((__m128i*)(d + 0), a);
+		_mm_storeu_si128((__m128i*)(d + 16), b);
+		_mm_storeu_si128((__m128i*)(d + 32), c);
+		_mm_storeu_si128((__m128i*)(d + 48), e);
+	}
+	for (; size >= 16; size -= 16, d += 16, s += 16)
+	{
+		_mm_storeu_si128((__m128i*)d, _mm_loadu_si128((const __m128i*)s));
+	}
+	// The last 16 bytes overlap what was already copied.
+	if (size > 0)
+	{
+		_mm_storeu_si128((__m128i*)(dest_end - 16), _mm_loadu_si128((const __m128i*)(end - 16)));
+	}
+	return dest;
+}
+
+static void* set_memory_sse2(void* dest, u8 value, size_t size)
+{
+	if (size < SIMD_MEMORY_MIN_SIZE)
+	{
+		return memset(dest, value, size);
+	}
+
+	__m128i v = _mm_set1_epi8((char)value);
+	u8* d = (u8*)dest;
+	u8* dest_end = d + size;
+	for (; size >= 64; size -= 64, d += 64)
+	{
+		_mm_storeu_si128((__m128i*)(d + 0), v);
+		_mm_storeu_si128((__m128i*)(d + 16), v);
+		_mm_storeu_si128((__m128i*)(d + 32), v);
+		_mm_storeu_si128((__m128i*)(d + 48), v);
+	}
+	for (; size >= 16; size -= 16, d += 16)
+	{
+		_mm_storeu_si128((__m128i*)d, v);
+	}
+	if (size > 0)
+	{
+		_mm_storeu_si128((__m128i*)(dest_end - 16), v);
+	}
+	return dest;
+}
+
+static s32 compare_memory_sse2(const void* a, const void* b, size_t size)
+{
+	if (size < 16)
+	{
+		return memcmp(a, b, size);
+	}
+
+	const u8* x = (const u8*)a;
+	const u8* y = (const u8*)b;
+	size_t offset = 0;
+
+	// Check 64 bytes at a time until something differs, then find it 16 bytes at a time.
+	for (; offset + 64 <= size; offset += 64)
+	{
+		__m128i e0 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(x + offset + 0)), _mm_loadu_si128((const __m128i*)(y + offset + 0)));
+		__m128i e1 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(x + offset + 16)), _mm_loadu_si128((const __m128i*)(y + offset + 16)));
+		__m128i e2 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(x + offset + 32)), _mm_loadu_si128((const __m128i*)(y + offset + 32)));
+		__m128i e3 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(x + offset + 48)), _mm_loadu_si128((const __m128i*)(y + offset + 48)));
+		if (_mm_movemask_epi8(_mm_and_si128(_mm_and_si128(e0, e1), _mm_and_si128(e2, e3))) != 0xFFFF)
+		{
+			break;
+		}
+	}
+	if (offset == size)
+	{
+		return 0;
+	}
+
+	for (;;)
+	{
+		// The last block is moved back to overlap, the bytes before it are known to match.
+		if (offset + 16 > size)
+		{
+			offset = size - 16;
+		}
+
+		__m128i equal = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(x + offset)), _mm_loadu_si128((const __m128i*)(y + offset)));
+		u32 mask = (u32)_mm_movemask_epi8(equal) ^ 0xFFFF;
+		if (mask != 0)
+		{
+			return compare_bytes_at(x + offset, y + offset, count_trailing_zeros_u64(mask));
+		}
+
+		offset += 16;
+		if (offset >= size)
+		{
+			return 0;
+		}
+	}
+}
+
+static void* stream_copy_memory_sse2(void* dest, const void* src, size_t size)
+{
+	if (size < STREAM_COPY_MIN_SIZE)
+	{
+		return copy_memory_sse2(dest, src, size);
+	}
+
+	u8* d = (u8*)dest;
+	const u8* s = (const u8*)src;
+	u8* dest_end = d + size;
+	const u8* end = s + size;
+
+	// Streaming stores need an aligned destination. Copy the first block normally
+	// and start streaming from the next aligned address.
+	_mm_storeu_si128((__m128i*)d, _mm_loadu_si128((const __m128i*)s));
+	size_t head = 16 - ((size_t)d & 15);
+	d += head;
+	s += head;
+	size -= head;
+
+	for (; size >= 64; size -= 64, d += 64, s += 64)
+	{
+		__m128i a = _mm_loadu_si128((const __m128i*)(s + 0));
+		__m128i b = _mm_loadu_si128((const __m128i*)(s + 16));
+		__m128i c = _mm_loadu_si128((const __m128i*)(s + 32));
+		__m128i e = _mm_loadu_si128((const __m128i*)(s + 48));
+		_mm_stream_si128((__m128i*)(d + 0), a);
+		_mm_stream_si128((__m128i*)(d + 16), b);
+		_mm_stream_si128((__m128i*)(d + 32), c);
+		_mm_stream_si128((__m128i*)(d + 48), e);
+	}
+	for (; size >= 16; size -= 16, d += 16, s += 16)
+	{
+		_mm_stream_si128((__m128i*)d, _mm_loadu_si128((const __m128i*)s));
+	}
+	// Order the streaming stores before anything that follows, like Unmap.
+	_mm_sfence();
+
+	if (size > 0)
+	{
+		_mm_storeu_si128((__m128i*)(dest_end - 16), _mm_loadu_si128((const __m128i*)(end - 16)));
+	}
+	return dest;
+}
+
+TARGET_AVX2 static void* copy_memory_avx2(void* dest, const void* src, size_t size)
+{
+	if (size < SIMD_MEMORY_MIN_SIZE)
+	{
+		return memcpy(dest, src, size);
+	}
+
+	u8* d = (u8*)dest;
+	const u8* s = (const u8*)src;
+	const u8* end = s + size;
+	u8* dest_end = d + size;
+	for (; size >= 128; size -= 128, d += 128, s += 128)
+	{
+		__m256i a = _mm256_loadu_si256((const __m256i*)(s + 0));
+		__m256i b = _mm256_loadu_si256((const __m256i*)(s + 32));
+		__m256i c = _mm256_loadu_si256((const __m256i*)(s + 64));
+		__m256i e = _mm256_loadu_si256((const __m256i*)(s + 96));
+		_mm256_storeu_si256((__m256i*)(d + 0), a);
+		_mm256_storeu_si256((__m256i*)(d + 32), b);
+		_mm256_storeu_si256((__m256i*)(d + 64), c);
+		_mm256_storeu_si256((__m256i*)(d + 96), e);
+	}
+	for (; size >= 32; size -= 32, d += 32, s += 32)
+	{
+		_mm256_storeu_si256((__m256i*)d, _mm256_loadu_si256((const __m256i*)s));
+	}
+	if (size > 0)
+	{
+		_mm256_storeu_si256((__m256i*)(dest_end - 32), _mm256_loadu_si256((const __m256i*)(end - 32)));
+	}
+	return dest;
+}
+
+TARGET_AVX2 static void* set_memory_avx2(void* dest, u8 value, size_t size)
+{
+	if (size < SIMD_MEMORY_MIN_SIZE)
+	{
+		return memset(dest, value, size);
+	}
+
+	__m256i v = _mm256_set1_epi8((char)value);
+	u8* d = (u8*)dest;
+	u8* dest_end = d + size;
+	for (; size >= 128; size -= 128, d += 128)
+	{
+		_mm256_storeu_si256((__m256i*)(d + 0), v);
+		_mm256_storeu_si256((__m256i*)(d + 32), v);
+		_mm256_storeu_si256((__m256i*)(d + 64), v);
+		_mm256_storeu_si256((__m256i*)(d + 96), v);
+	}
+	for (; size >= 32; size -= 32, d += 32)
+	{
+		_mm256_storeu_si256((__m256i*)d, v);
+	}
+	if (size > 0)
+	{
+		_mm256_storeu_si256((__m256i*)(dest_end - 32), v);
+	}
+	return dest;
+}
+
+TARGET_AVX2 static s32 compare_memory_avx2(const void* a, const void* b, size_t size)
+{
+	if (size < 32)
+	{
+		return compare_memory_sse2(a, b, size);
+	}
+
+	const u8* x = (const u8*)a;
+	const u8* y = (const u8*)b;
+	size_t offset = 0;
+
+	for (; offset + 128 <= size; offset += 128)
+	{
+		__m256i e0 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(x + offset + 0)), _mm256_loadu_si256((const __m256i*)(y + offset + 0)));
+		__m256i e1 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(x + offset + 32)), _mm256_loadu_si256((const __m256i*)(y + offset + 32)));
+		__m256i e2 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(x + offset + 64)), _mm256_loadu_si256((const __m256i*)(y + offset + 64)));
+		__m256i e3 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(x + offset + 96)), _mm256_loadu_si256((const __m256i*)(y + offset + 96)));
+		if ((u32)_mm256_movemask_epi8(_mm256_and_si256(_mm256_and_si256(e0, e1), _mm256_and_si256(e2, e3))) != 0xFFFFFFFF)
+		{
+			break;
+		}
+	}
+	if (offset == size)
+	{
+		return 0;
+	}
+
+	for (;;)
+	{
+		if (offset + 32 > size)
+		{
+			offset = size - 32;
+		}
+
+		__m256i equal = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(x + offset)), _mm256_loadu_si256((const __m256i*)(y + offset)));
+		u32 mask = ~(u32)_mm256_movemask_epi8(equal);
+		if (mask != 0)
+		{
+			return compare_bytes_at(x + offset, y + offset, count_trailing_zeros_u64(mask));
+		}
+
+		offset += 32;
+		if (offset >= size)
+		{
+			return 0;
+		}
+	}
+}
+
+TARGET_AVX2 static void* stream_copy_memory_avx2(void* dest, const void* src, size_t size)
+{
+	if (size < STREAM_COPY_MIN_SIZE)
+	{
+		return copy_memory_avx2(dest, src, size);
+	}
+
+	u8* d = (u8*)dest;
+	const u8* s = (const u8*)src;
+	u8* dest_end = d + size;
+	const u8* end = s + size;
+
+	_mm256_storeu_si256((__m256i*)d, _mm256_loadu_si256((const __m256i*)s));
+	size_t head = 32 - ((size_t)d & 31);
+	d += head;
+	s += head;
+	size -= head;
+
+	for (; size >= 128; size -= 128, d += 128, s += 128)
+	{
+		__m256i a = _mm256_loadu_si256((const __m256i*)(s + 0));
+		__m256i b = _mm256_loadu_si256((const __m256i*)(s + 32));
+		__m256i c = _mm256_loadu_si256((const __m256i*)(s + 64));
+		__m256i e = _mm256_loadu_si256((const __m256i*)(s + 96));
+		_mm256_stream_si256((__m256i*)(d + 0), a);
+		_mm256_stream_si256((__m256i*)(d + 32), b);
+		_mm256_stream_si256((__m256i*)(d + 64), c);
+		_mm256_stream_si256((__m256i*)(d + 96), e);
+	}
+	for (; size >= 32; size -= 32, d += 32, s += 32)
+	{
+		_mm256_stream_si256((__m256i*)d, _mm256_loadu_si256((const __m256i*)s));
+	}
+	_mm_sfence();
+
+	if (size > 0)
+	{
+		_mm256_storeu_si256((__m256i*)(dest_end - 32), _mm256_loadu_si256((const __m256i*)(end - 32)));
+	}
+	return dest;
+}
+
+// AVX-512BW masked loads and stores handle the tail without overlapping.
+TARGET_AVX512 static void* copy_memory_avx512(void* dest, const void* src, size_t size)
+{
+	u8* d = (u8*)dest;
+	const u8* s = (const u8*)src;
+	for (; size >= 128; size -= 128, d += 128, s += 128)
+	{
+		__m512i a = _mm512_loadu_si512((const void*)(s + 0));
+		__m512i b = _mm512_loadu_si512((const void*)(s + 64));
+		_mm512_storeu_si512((void*)(d + 0), a);
+		_mm512_storeu_si512((void*)(d + 64), b);
+	}
+	for (; size >= 64; size -= 64, d += 64, s += 64)
+	{
+		_mm512_storeu_si512((void*)d, _mm512_loadu_si512((const void*)s));
+	}
+	if (size > 0)
+	{
+		__mmask64 mask = (1ull << size) - 1;
+		_mm512_mask_storeu_epi8(d, mask, _mm512_maskz_loadu_epi8(mask, s));
+	}
+	return dest;
+}
+
+TARGET_AVX512 static void* set_memory_avx512(void* dest, u8 value, size_t size)
+{
+	__m512i v = _mm512_set1_epi8((char)value);
+	u8* d = (u8*)dest;
+	for (; size >= 128; size -= 128, d += 128)
+	{
+		_mm512_storeu_si512((void*)(d + 0), v);
+		_mm512_storeu_si512((void*)(d + 64), v);
+	}
+	for (; size >= 64; size -= 64, d += 64)
+	{
+		_mm512_storeu_si512((void*)d, v);
+	}
+	if (size > 0)
+	{
+		_mm512_mask_storeu_epi8(d, (1ull << size) - 1, v);
+	}
+	return dest;
+}
+
+TARGET_AVX512 static s32 compare_memory_avx512(const void* a, const void* b, size_t size)
+{
+	const u8* x = (const u8*)a;
+	const u8* y = (const u8*)b;
+	while (size > 0)
+	{
+		__mmask64 load_mask = (size >= 64) ? ~0ull : (1ull << size) - 1;
+		__m512i u = _mm512_maskz_loadu_epi8(load_mask, x);
+		__m512i v = _mm512_maskz_loadu_epi8(load_mask, y);
+		u64 different = _mm512_cmpneq_epu8_mask(u, v);
+		if (different != 0)
+		{
+			return compare_bytes_at(x, y, count_trailing_zeros_u64(different));
+		}
+
+		size_t step = (size >= 64) ? 64 : size;
+		x += step;
+		y += step;
+		size -= step;
+	}
+	return 0;
+}
+
+TARGET_AVX512 static void* stream_copy_memory_avx512(void* dest, const void* src, size_t size)
+{
+	if (size < STREAM_COPY_MIN_SIZE)
+	{
+		return copy_memory_avx512(dest, src, size);
+	}
+
+	u8* d = (u8*)dest;
+	const u8* s = (const u8*)src;
+
+	// Masked store up to the first 64 byte boundary.
+	size_t head = (64 - ((size_t)d & 63)) & 63;
+	if (head > 0)
+	{
+		__mmask64 mask = (1ull << head) - 1;
+		_mm512_mask_storeu_epi8(d, mask, _mm512_maskz_loadu_epi8(mask, s));
+		d += head;
+		s += head;
+		size -= head;
+	}
+
+	for (; size >= 128; size -= 128, d += 128, s += 128)
+	{
+		__m512i a = _mm512_loadu_si512((const void*)(s + 0));
+		__m512i b = _mm512_loadu_si512((const void*)(s + 64));
+		_mm512_stream_si512((__m512i*)(d + 0), a);
+		_mm512_stream_si512((__m512i*)(d + 64), b);
+	}
+	for (; size >= 64; size -= 64, d += 64, s += 64)
+	{
+		_mm512_stream_si512((__m512i*)d, _mm512_loadu_si512((const void*)s));
+	}
+	_mm_sfence();
+
+	if (size > 0)
+	{
+		__mmask64 mask = (1ull << size) - 1;
+		_mm512_mask_storeu_epi8(d, mask, _mm512_maskz_loadu_epi8(mask, s));
+	}
+	return dest;
+}
+
+static void cpuid(u32 leaf, u32 subleaf, u32 registers[4])
+{
+#if defined(_MSC_VER)
+	__cpuidex((int*)registers, (int)leaf, (int)subleaf);
+#else
+	__cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+}
+
+// Which register states the OS saves on context switches.
+static u64 read_xcr0()
+{
+#if defined(_MSC_VER)
+	return _xgetbv(0);
+#else
+	u32 eax, edx;
+	__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+	return ((u64)edx << 32) | eax;
+#endif
+}
+#endif // MEMORY_X64
+
+#if MEMORY_NEON
+// NEON has no non-temporal store intrinsic, so streaming copies are regular copies here.
+static void* copy_memory_neon(void* dest, const void* src, size_t size)
+{
+	if (size < SIMD_MEMORY_MIN_SIZE)
+	{
+		return memcpy(dest, src, size);
+	}
+
+	u8* d = (u8*)dest;
+	const u8* s = (const u8*)src;
+	const u8* end = s + size;
+	u8* dest_end = d + size;
+	for (; size >= 64; size -= 64, d += 64, s += 64)
+	{
+		uint8x16x4_t block = vld1q_u8_x4(s);
+		vst1q_u8_x4(d, block);
+	}
+	for (; size >= 16; size -= 16, d += 16, s += 16)
+	{
+		vst1q_u8(d, vld1q_u8(s));
+	}
+	if (size > 0)
+	{
+		vst1q_u8(dest_end - 16, vld1q_u8(end - 16));
+	}
+	return dest;
+}
+
+static void* set_memory_neon(void* dest, u8 value, size_t size)
+{
+	if (size < SIMD_MEMORY_MIN_SIZE)
+	{
+		return memset(dest, value, size);
+	}
+
+	uint8x16_t v = vdupq_n_u8(value);
+	u8* d = (u8*)dest;
+	u8* dest_end = d + size;
+	for (; size >= 16; size -= 16, d += 16)
+	{
+		vst1q_u8(d, v);
+	}
+	if (size > 0)
+	{
+		vst1q_u8(dest_end - 16, v);
+	}
+	return dest;
+}
+
+static s32 compare_memory_neon(const void* a, const void* b, size_t size)
+{
+	if (size < 16)
+	{
+		return memcmp(a, b, size);
+	}
+
+	const u8* x = (const u8*)a;
+	const u8* y = (const u8*)b;
+	size_t offset = 0;
+	for (;;)
+	{
+		if (offset + 16 > size)
+		{
+			offset = size - 16;
+		}
+
+		uint8x16_t equal = vceqq_u8(vld1q_u8(x + offset), vld1q_u8(y + offset));
+		if (vminvq_u8(equal) != 0xFF)
+		{
+			return memcmp(x + offset, y + offset, 16);
+		}
+
+		offset += 16;
+		if (offset >= size)
+		{
+			return 0;
+		}
+	}
+}
+#endif // MEMORY_NEON
+
+static const char* memory_implementation_names[(u32)MemoryImplementation::MEMORY_IMPLEMENTATION_MAX_IMPLEMENTATIONS] =
+{
+	"libc", "sse2", "avx2", "avx512", "neon"
+};
+
+static MemoryFunctions memory_function_table[(u32)MemoryImplementation::MEMORY_IMPLEMENTATION_MAX_IMPLEMENTATIONS] =
+{
+	{ copy_memory_libc, set_memory_libc, compare_memory_libc, copy_memory_libc },
+#if MEMORY_X64
+	{ copy_memory_sse2, set_memory_sse2, compare_memory_sse2, stream_copy_memory_sse2 },
+	{ copy_memory_avx2, set_memory_avx2, compare_memory_avx2, stream_copy_memory_avx2 },
+	{ copy_memory_avx512, set_memory_avx512, compare_memory_avx512, stream_copy_memory_avx512 },
+#else
+	{}, {}, {},
+#endif
+#if MEMORY_NEON
+	{ copy_memory_neon, set_memory_neon, compare_memory_neon, copy_memory_neon },
+#else
+	{},
+#endif
+};
+
+static u32 supported_implementations = 1u << (u32)MemoryImplementation::MEMORY_IMPLEMENTATION_LIBC;
+static MemoryImplementation current_implementation = MemoryImplementation::MEMORY_IMPLEMENTATION_LIBC;
+static MemoryFunctions memory_functions = { copy_memory_libc, set_memory_libc, compare_memory_libc, copy_memory_libc };
+
+void initialize_memory_functions()
+{
+	supported_implementations = 1u << (u32)MemoryImplementation::MEMORY_IMPLEMENTATION_LIBC;
+	MemoryImplementation best = MemoryImplementation::MEMORY_IMPLEMENTATION_LIBC;
+
+#if MEMORY_X64
+	supported_implementations |= 1u << (u32)MemoryImplementation::MEMORY_IMPLEMENTATION_SSE2;
+	best = MemoryImplementation::MEMORY_IMPLEMENTATION_SSE2;
+
+	u32 leaf1[4];
+	u32 leaf7[4] = {};
+	cpuid(1, 0, leaf1);
+	u32 max_leaf[4];
+	cpuid(0, 0, max_leaf);
+	if (max_leaf[0] >= 7)
+	{
+		cpuid(7, 0, leaf7);
+	}
+
+	// The CPU supporting AVX isn't enough, the OS also has to save the wider registers.
+	bool os_saves_ymm = false;
+	bool os_saves_zmm = false;
+	bool has_osxsave = (leaf1[2] >> 27) & 1;
+	if (has_osxsave)
+	{
+		u64 xcr0 = read_xcr0();
+		os_saves_ymm = (xcr0 & 0x6) == 0x6;
+		os_saves_zmm = (xcr0 & 0xE6) == 0xE6;
+	}
+
+	bool has_avx2 = ((leaf1[2] >> 28) & 1) && ((leaf7[1] >> 5) & 1);
+	bool has_avx512 = ((leaf7[1] >> 16) & 1) && ((leaf7[1] >> 30) & 1); // AVX-512F and BW.
+
+	if (has_avx2 && os_saves_ymm)
+	{
+		supported_implementations |= 1u << (u32)MemoryImplementation::MEMORY_IMPLEMENTATION_AVX2;
+		best = MemoryImplementation::MEMORY_IMPLEMENTATION_AVX2;
+	}
+	if (has_avx512 && os_saves_zmm)
+	{
+		supported_implementations |= 1u << (u32)MemoryImplementation::MEMORY_IMPLEMENTATION_AVX512;
+		best = MemoryImplementation::MEMORY_IMPLEMENTATION_AVX512;
+	}
+#elif MEMORY_NEON
+	// NEON is part of AArch64.
+	supported_implementations |= 1u << (u32)MemoryImplementation::MEMORY_IMPLEMENTATION_NEON;
+	best = MemoryImplementation::MEMORY_IMPLEMENTATION_NEON;
+#endif
+
+	select_memory_implementation(best);
+}
+
+bool is_memory_implementation_supported(MemoryImplementation implementation)
+{
+	return (supported_implementations >> (u32)implementation) & 1;
+}
+
+bool select_memory_implementation(MemoryImplementation implementation)
+{
+	if (!is_memory_implementation_supported(implementation))
+	{
+		return false;
+	}
+
+	memory_functions = memory_function_table[(u32)implementation];
+	current_implementation = implementation;
+	return true;
+}
+
+MemoryImplementation get_memory_implementation()
+{
+	return current_implementation;
+}
+
+const char* get_memory_implementation_name(MemoryImplementation implementation)
+{
+	return memory_implementation_names[(u32)implementation];
+}
+
+void* copy_memory(void* dest, const void* src, size_t size)
+{
+	return memory_functions.copy(dest, src, size);
+}
+
+void* set_memory(void* dest, u8 value, size_t size)
+{
+	return memory_functions.set(dest, value, size);
+}
+
+s32 compare_memory(const void* a, const void* b, size_t size)
+{
+	return memory_functions.compare(a, b, size);
+}
+
+void* stream_copy_memory(void* dest, const void* src, size_t size)
+{
+	return memory_functions.stream_copy(dest, src, size);
+}
\ No newline at end of file
@@ -0,0 +1,478 @@
+#include "core/platform/platform.h"
+
+#if PLATFORM_LINUX
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// io_uring is driven through the raw syscalls so there is no liburing dependency.
+// Kernels without it (or sandboxes that block it) get synchronous reads behind the
+// same interface.
+struct IoUring
+{
+	s32 fd;
+	u32 features;
+
+	u32* sq_head;
+	u32* sq_tail;
+	u32 sq_mask;
+	u32* sq_array;
+	io_uring_sqe* sqes;
+
+	u32* cq_head;
+	u32* cq_tail;
+	u32 cq_mask;
+	io_uring_cqe* cqes;
+
+	void* sq_ring;
+	u64 sq_ring_size;
+	void* cq_ring;
+	u64 cq_ring_size;
+	u64 sqes_size;
+};
+
+struct AsyncReadSlot
+{
+	AsyncFileRead* read;
+	s32 fd;
+	// Synchronous fallback only, the result waiting for poll_async_reads.
+	bool done;
+	s64 result;
+};
+
+struct AsyncIo
+{
+	bool initialized;
+	bool use_ring;
+	// Set after io_uring_enter fails to submit. Reads already in the kernel still
+	// complete through the ring, new ones are done synchronously.
+	bool ring_failed;
+	IoUring ring;
+	// Queued in the submission ring but not yet taken by the kernel.
+	u32 unsubmitted;
+	AsyncReadSlot* slots;
+	u32 slot_count;
+	u32 in_flight;
+};
+
+static AsyncIo async_io = {};
+
+static s32 io_uring_setup(u32 entries, io_uring_params* params)
+{
+	return (s32)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static s32 io_uring_enter(s32 fd, u32 to_submit, u32 min_complete, u32 flags, const void* arg, u64 arg_size)
+{
+	return (s32)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, arg, arg_size);
+}
+
+static bool create_ring(IoUring* ring, u32 entries)
+{
+	io_uring_params params = {};
+	ring->fd = io_uring_setup(entries, &params);
+	if (ring->fd < 0)
+	{
+		return false;
+	}
+	ring->features = params.features;
+
+	ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(u32);
+	ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+	ring->sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+
+	ring->sq_ring = mmap(nullptr, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+	ring->cq_ring = mmap(nullptr, ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+	void* sqes = mmap(nullptr, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+	if (ring->sq_ring == MAP_FAILED || ring->cq_ring == MAP_FAILED || sqes == MAP_FAILED)
+	{
+		if (ring->sq_ring != MAP_FAILED)
+		{
+			munmap(ring->sq_ring, ring->sq_ring_size);
+		}
+		if (ring->cq_ring != MAP_FAILED)
+		{
+			munmap(ring->cq_ring, ring->cq_ring_size);
+		}
+		if (sqes != MAP_FAILED)
+		{
+			munmap(sqes, ring->sqes_size);
+		}
+		close(ring->fd);
+		return false;
+	}
+
+	u8* sq = (u8*)ring->sq_ring;
+	ring->sq_head = (u32*)(sq + params.sq_off.head);
+	ring->sq_tail = (u32*)(sq + params.sq_off.tail);
+	ring->sq_mask = *(u32*)(sq + params.sq_off.ring_mask);
+	ring->sq_array = (u32*)(sq + params.sq_off.array);
+	ring->sqes = (io_uring_sqe*)sqes;
+
+	u8* cq = (u8*)ring->cq_ring;
+	ring->cq_head = (u32*)(cq + params.cq_off.head);
+	ring->cq_tail = (u32*)(cq + params.cq_off.tail);
+	ring->cq_mask = *(u32*)(cq + params.cq_off.ring_mask);
+	ring->cqes = (io_uring_cqe*)(cq + params.cq_off.cqes);
+	return true;
+}
+
+static void destroy_ring(IoUring* ring)
+{
+	munmap(ring->sqes, ring->sqes_size);
+	munmap(ring->cq_ring, ring->cq_ring_size);
+	munmap(ring->sq_ring, ring->sq_ring_size);
+	close(ring->fd);
+}
+
+// Only queues the entry, it goes to the kernel with the next io_uring_enter.
+static void queue_ring_read(IoUring* ring, u32 slot_index)
+{
+	AsyncReadSlot* slot = &async_io.slots[slot_index];
+	AsyncFileRead* read = slot->read;
+	u64 remaining = read->buffer_size - read->bytes_read;
+
+	u32 tail = *ring->sq_tail;
+	u32 index = tail & ring->sq_mask;
+	io_uring_sqe* sqe = &ring->sqes[index];
+	memset(sqe, 0, sizeof(*sqe));
+	sqe->opcode = IORING_OP_READ;
+	sqe->fd = slot->fd;
+	sqe->addr = (u64)(uintptr_t)((u8*)read->buffer + read->bytes_read);
+	sqe->len = remaining > 0x7FFFF000 ? 0x7FFFF000 : (u32)remaining;
+	sqe->off = read->offset + read->bytes_read;
+	sqe->user_data = slot_index;
+	ring->sq_array[index] = index;
+	__atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+	async_io.unsubmitted++;
+}
+
+static void finish_read(u32 slot_index, bool succeeded)
+{
+	AsyncReadSlot* slot = &async_io.slots[slot_index];
+	AsyncFileRead* read = slot->read;
+	close(slot->fd);
+	*slot = {};
+	async_io.in_flight--;
+
+	read->status = succeeded ? AsyncReadStatus::ASYNC_READ_STATUS_COMPLETE : AsyncReadStatus::ASYNC_READ_STATUS_FAILED;
+	if (read->callback)
+	{
+		read->callback(read);
+	}
+}
+
+// Returns the total bytes read into the buffer, including any read before the call.
+static s64 read_synchronously(AsyncReadSlot* slot)
+{
+	AsyncFileRead* read = slot->read;
+	u8* dest = (u8*)read->buffer;
+	u64 total = read->bytes_read;
+	while (total < read->buffer_size)
+	{
+		ssize_t size = pread(slot->fd, dest + total, read->buffer_size - total, (off_t)(read->offset + total));
+		if (size < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		if (size < 0)
+		{
+			return -errno;
+		}
+		if (size == 0)
+		{
+			break;
+		}
+		total += (u64)size;
+	}
+	return (s64)total;
+}
+
+// Reads the rest of the buffer, through the ring unless it has failed.
+// Synchronous results are picked up by the next poll_async_reads.
+static void queue_read(u32 slot_index)
+{
+	if (async_io.use_ring && !async_io.ring_failed)
+	{
+		queue_ring_read(&async_io.ring, slot_index);
+		return;
+	}
+
+	AsyncReadSlot* slot = &async_io.slots[slot_index];
+	slot->result = read_synchronously(slot);
+	slot->done = true;
+}
+
+// Entries the kernel never took won't complete, so their reads fail here and
+// later reads skip the ring.
+static void fail_unsubmitted_reads()
+{
+	IoUring* ring = &async_io.ring;
+	u32 head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+	u32 tail = *ring->sq_tail;
+	__atomic_store_n(ring->sq_tail, head, __ATOMIC_RELEASE);
+	async_io.unsubmitted = 0;
+	async_io.ring_failed = true;
+
+	for (u32 i = head; i != tail; ++i)
+	{
+		u32 slot_index = (u32)ring->sqes[ring->sq_array[i & ring->sq_mask]].user_data;
+		finish_read(slot_index, false);
+	}
+}
+
+// Submits every queued entry, and with IORING_ENTER_GETEVENTS waits for
+// min_complete completions.
+static void enter_ring(u32 min_complete, u32 flags, const void* arg, u64 arg_size)
+{
+	s32 result = io_uring_enter(async_io.ring.fd, async_io.unsubmitted, min_complete, flags, arg, arg_size);
+	if (result >= 0)
+	{
+		async_io.unsubmitted -= (u32)result;
+		return;
+	}
+
+	// A wait that timed out or was interrupted with nothing to submit loses nothing.
+	if (async_io.unsubmitted > 0)
+	{
+		fail_unsubmitted_reads();
+	}
+}
+
+// Returns true if the read is done, false if it was requeued for the rest of the buffer.
+static bool handle_read_result(u32 slot_index, s64 result)
+{
+	AsyncFileRead* read = async_io.slots[slot_index].read;
+	if (result == -EAGAIN || result == -EINTR)
+	{
+		queue_read(slot_index);
+		return false;
+	}
+	if (result < 0)
+	{
+		finish_read(slot_index, false);
+		return true;
+	}
+
+	read->bytes_read += (u64)result;
+	if (result > 0 && read->bytes_read < read->buffer_size)
+	{
+		// Short read, reads are capped at 2GB and may stop early.
+		queue_read(slot_index);
+		return false;
+	}
+
+	finish_read(slot_index, true);
+	return true;
+}
+
+// Sleeps in the kernel until a read completes or timeout_ns passes. Without
+// IORING_FEAT_EXT_ARG there's no timeout, so it only yields.
+static void wait_for_ring(u64 timeout_ns)
+{
+	if (!(async_io.ring.features & IORING_FEAT_EXT_ARG))
+	{
+		if (async_io.unsubmitted > 0)
+		{
+			enter_ring(0, 0, nullptr, 0);
+		}
+		sched_yield();
+		return;
+	}
+
+	__kernel_timespec timeout = {};
+	timeout.tv_sec = (s64)(timeout_ns / 1000000000ull);
+	timeout.tv_nsec = (s64)(timeout_ns % 1000000000ull);
+	io_uring_getevents_arg arg = {};
+	arg.ts = (u64)(uintptr_t)&timeout;
+	enter_ring(1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+}
+
+bool initialize_async_io(u32 queue_depth)
+{
+	shutdown_async_io();
+
+	async_io.slots = (AsyncReadSlot*)calloc(queue_depth, sizeof(AsyncReadSlot));
+	if (async_io.slots == nullptr)
+	{
+		return false;
+	}
+	async_io.slot_count = queue_depth;
+	async_io.use_ring = create_ring(&async_io.ring, queue_depth);
+	async_io.initialized = true;
+	return true;
+}
+
+void shutdown_async_io()
+{
+	if (!async_io.initialized)
+	{
+		return;
+	}
+
+	// The kernel may still be writing into caller buffers.
+	u64 start = get_performance_counter();
+	u64 timeout_ticks = get_performance_frequency() * ASYNC_IO_SHUTDOWN_TIMEOUT_MS / 1000;
+	for (;;)
+	{
+		poll_async_reads();
+		if (async_io.in_flight == 0)
+		{
+			break;
+		}
+
+		u64 elapsed = get_performance_counter() - start;
+		if (elapsed >= timeout_ticks)
+		{
+			async_io = {};
+			return;
+		}
+		if (async_io.use_ring)
+		{
+			wait_for_ring((timeout_ticks - elapsed) * 1000000000ull / get_performance_frequency());
+		}
+	}
+
+	if (async_io.use_ring)
+	{
+		destroy_ring(&async_io.ring);
+	}
+	free(async_io.slots);
+	async_io = {};
+}
+
+u32 submit_async_reads(AsyncFileRead* reads, u32 count)
+{
+	u32 submitted = 0;
+	u32 slot_index = 0;
+	for (; submitted < count; ++submitted)
+	{
+		while (slot_index < async_io.slot_count && async_io.slots[slot_index].read != nullptr)
+		{
+			slot_index++;
+		}
+		if (slot_index == async_io.slot_count)
+		{
+			break;
+		}
+
+		AsyncFileRead* read = &reads[submitted];
+		read->bytes_read = 0;
+		read->slot = slot_index;
+		read->status = AsyncReadStatus::ASYNC_READ_STATUS_PENDING;
+
+		s32 fd = open(read->path, O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+		{
+			read->status = AsyncReadStatus::ASYNC_READ_STATUS_FAILED;
+			if (read->callback)
+			{
+				read->callback(read);
+			}
+			continue;
+		}
+
+		AsyncReadSlot* slot = &async_io.slots[slot_index];
+		slot->read = read;
+		slot->fd = fd;
+		async_io.in_flight++;
+		queue_read(slot_index);
+	}
+
+	// One syscall for the whole batch.
+	if (async_io.unsubmitted > 0)
+	{
+		enter_ring(0, 0, nullptr, 0);
+	}
+	return submitted;
+}
+
+u32 poll_async_reads()
+{
+	u32 finished = 0;
+	if (async_io.use_ring)
+	{
+		IoUring* ring = &async_io.ring;
+		u32 head = *ring->cq_head;
+		u32 tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+		while (head != tail)
+		{
+			io_uring_cqe* cqe = &ring->cqes[head & ring->cq_mask];
+			u32 slot_index = (u32)cqe->user_data;
+			s64 result = cqe->res;
+			head++;
+
+			if (handle_read_result(slot_index, result))
+			{
+				finished++;
+			}
+		}
+		__atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+
+		// Requeued reads, and any left over from a partial submit.
+		if (async_io.unsubmitted > 0)
+		{
+			enter_ring(0, 0, nullptr, 0);
+		}
+	}
+
+	if (async_io.use_ring && !async_io.ring_failed)
+	{
+		return finished;
+	}
+
+	for (u32 i = 0; i < async_io.slot_count; ++i)
+	{
+		if (async_io.slots[i].done)
+		{
+			s64 result = async_io.slots[i].result;
+			AsyncFileRead* read = async_io.slots[i].read;
+			if (result >= 0)
+			{
+				read->bytes_read = (u64)result;
+			}
+			finish_read(i, result >= 0);
+			finished++;
+		}
+	}
+	return finished;
+}
+
+bool wait_for_async_read(AsyncFileRead* read, u32 timeout_ms)
+{
+	u64 start = get_performance_counter();
+	u64 timeout_ticks = get_performance_frequency() * timeout_ms / 1000;
+	for (;;)
+	{
+		poll_async_reads();
+		if (read->status != AsyncReadStatus::ASYNC_READ_STATUS_PENDING)
+		{
+			return read->status == AsyncReadStatus::ASYNC_READ_STATUS_COMPLETE;
+		}
+
+		u64 elapsed = get_performance_counter() - start;
+		if (elapsed >= timeout_ticks)
+		{
+			return false;
+		}
+
+		if (async_io.use_ring)
+		{
+			wait_for_ring((timeout_ticks - elapsed) * 1000000000ull / get_performance_frequency());
+		}
+		else
+		{
+			sched_yield();
+		}
+	}
+}
+
+#endif
\ No newline at end of file
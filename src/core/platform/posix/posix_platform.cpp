@@ -0,0 +1,693 @@
+#include "core/platform/platform.h"
+
+#if PLATFORM_LINUX
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+// Virtual memory.
+u64 get_page_size()
+{
+	return (u64)sysconf(_SC_PAGESIZE);
+}
+
+u64 get_large_page_size()
+{
+	// Transparent huge pages are the size of a PMD, 2MB on x86-64 and usually on ARM64.
+	u64 size = 0;
+	s32 fd = open("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", O_RDONLY);
+	if (fd >= 0)
+	{
+		char text[32] = {};
+		if (read(fd, text, sizeof(text) - 1) > 0)
+		{
+			size = strtoull(text, nullptr, 10);
+		}
+		close(fd);
+	}
+	return size;
+}
+
+void* reserve_memory(u64 size, bool large_pages)
+{
+	void* address = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (address == MAP_FAILED)
+	{
+		return nullptr;
+	}
+
+#ifdef MADV_HUGEPAGE
+	if (large_pages)
+	{
+		// Only a hint, committed pages are backed by huge pages where the range is aligned.
+		madvise(address, size, MADV_HUGEPAGE);
+	}
+#endif
+
+	return address;
+}
+
+// mprotect and madvise want page aligned ranges.
+static void align_to_pages(void** address, u64* size)
+{
+	u64 page_size = get_page_size();
+	uintptr_t begin = (uintptr_t)*address & ~(uintptr_t)(page_size - 1);
+	uintptr_t end = ((uintptr_t)*address + *size + page_size - 1) & ~(uintptr_t)(page_size - 1);
+	*address = (void*)begin;
+	*size = end - begin;
+}
+
+bool commit_memory(void* address, u64 size)
+{
+	// Physical pages are still only allocated when first touched.
+	align_to_pages(&address, &size);
+	return mprotect(address, size, PROT_READ | PROT_WRITE) == 0;
+}
+
+void decommit_memory(void* address, u64 size)
+{
+	align_to_pages(&address, &size);
+	madvise(address, size, MADV_DONTNEED);
+	mprotect(address, size, PROT_NONE);
+}
+
+void release_memory(void* address, u64 size)
+{
+	munmap(address, size);
+}
+
+// Timing.
+u64 get_performance_counter()
+{
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (u64)now.tv_sec * 1000000000ull + (u64)now.tv_nsec;
+}
+
+u64 get_performance_frequency()
+{
+	return 1000000000ull;
+}
+
+// Threads.
+static u32 get_current_thread_id()
+{
+	return (u32)syscall(SYS_gettid);
+}
+
+static void* posix_thread_entry(void* param)
+{
+	PlatformThread* thread = (PlatformThread*)param;
+	__atomic_store_n(&thread->id, get_current_thread_id(), __ATOMIC_RELEASE);
+	thread->proc(thread->data);
+	return nullptr;
+}
+
+bool create_thread(PlatformThread* thread, ThreadProc proc, void* data, const char* name)
+{
+	thread->proc = proc;
+	thread->data = data;
+	thread->id = 0;
+
+	pthread_t* handle = (pthread_t*)malloc(sizeof(pthread_t));
+	if (pthread_create(handle, nullptr, posix_thread_entry, thread) != 0)
+	{
+		free(handle);
+		thread->handle = nullptr;
+		return false;
+	}
+
+	thread->handle = handle;
+	if (name)
+	{
+		set_thread_name(thread, name);
+	}
+
+	// setpriority needs the kernel thread id, which only the new thread can read.
+	while (__atomic_load_n(&thread->id, __ATOMIC_ACQUIRE) == 0)
+	{
+		sched_yield();
+	}
+	return true;
+}
+
+bool join_thread(PlatformThread* thread, u32 timeout_ms)
+{
+	pthread_t* handle = (pthread_t*)thread->handle;
+
+	timespec deadline;
+	clock_gettime(CLOCK_REALTIME, &deadline);
+	deadline.tv_sec += timeout_ms / 1000;
+	deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000;
+	if (deadline.tv_nsec >= 1000000000)
+	{
+		deadline.tv_sec++;
+		deadline.tv_nsec -= 1000000000;
+	}
+
+	if (pthread_timedjoin_np(*handle, nullptr, &deadline) != 0)
+	{
+		return false;
+	}
+
+	free(handle);
+	thread->handle = nullptr;
+	return true;
+}
+
+void yield_thread()
+{
+	sched_yield();
+}
+
+static pthread_t get_pthread(PlatformThread* thread)
+{
+	return thread ? *(pthread_t*)thread->handle : pthread_self();
+}
+
+void set_thread_name(PlatformThread* thread, const char* name)
+{
+	char short_name[16];
+	snprintf(short_name, sizeof(short_name), "%s", name);
+	pthread_setname_np(get_pthread(thread), short_name);
+}
+
+bool set_thread_affinity(PlatformThread* thread, u64 processor_mask)
+{
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	for (u32 i = 0; i < 64; ++i)
+	{
+		if (processor_mask & (1ull << i))
+		{
+			CPU_SET(i, &set);
+		}
+	}
+	return pthread_setaffinity_np(get_pthread(thread), sizeof(set), &set) == 0;
+}
+
+bool set_thread_priority(PlatformThread* thread, ThreadPriority priority)
+{
+	// SCHED_OTHER threads only have a nice value, and on Linux it is per thread.
+	static const int nice_values[] = { 15, 5, 0, -5, -15 };
+	u32 id = thread ? thread->id : get_current_thread_id();
+	return setpriority(PRIO_PROCESS, id, nice_values[(u32)priority]) == 0;
+}
+
+u32 get_current_processor()
+{
+	s32 processor = sched_getcpu();
+	return processor >= 0 ? (u32)processor : 0;
+}
+
+// CPU topology.
+static bool read_sysfs_file(const char* path, char* text, u32 text_size)
+{
+	s32 fd = open(path, O_RDONLY);
+	if (fd < 0)
+	{
+		return false;
+	}
+
+	ssize_t size = read(fd, text, text_size - 1);
+	close(fd);
+	if (size <= 0)
+	{
+		return false;
+	}
+	text[size] = '\0';
+	return true;
+}
+
+static u32 read_sysfs_u32(const char* path)
+{
+	char text[64];
+	return read_sysfs_file(path, text, sizeof(text)) ? (u32)strtoul(text, nullptr, 10) : 0;
+}
+
+// Lists look like "0-3,8-11".
+static u64 parse_processor_list(const char* text)
+{
+	u64 mask = 0;
+	while (*text >= '0' && *text <= '9')
+	{
+		char* end;
+		u32 first = (u32)strtoul(text, &end, 10);
+		u32 last = first;
+		if (*end == '-')
+		{
+			last = (u32)strtoul(end + 1, &end, 10);
+		}
+		for (u32 i = first; i <= last && i < CPU_MAX_LOGICAL_PROCESSORS; ++i)
+		{
+			mask |= 1ull << i;
+		}
+		text = (*end == ',') ? end + 1 : end;
+	}
+	return mask;
+}
+
+// Cache sizes are written like "32K".
+static u32 parse_cache_size(const char* text)
+{
+	char* end;
+	u32 size = (u32)strtoul(text, &end, 10);
+	if (*end == 'K')
+	{
+		size *= 1024;
+	}
+	else if (*end == 'M')
+	{
+		size *= 1024 * 1024;
+	}
+	return size;
+}
+
+static void fill_flat_topology(CpuTopology* topology, u32 processor_count)
+{
+	*topology = {};
+	topology->logical_processor_count = processor_count;
+	topology->core_count = processor_count;
+	topology->cache_domain_count = 1;
+	topology->cache_line_size = 64;
+	for (u32 i = 0; i < processor_count; ++i)
+	{
+		topology->cores[i].processor_mask = 1ull << i;
+		topology->cache_domains[0].processor_mask |= 1ull << i;
+	}
+}
+
+bool get_cpu_topology(CpuTopology* topology)
+{
+	s64 online = sysconf(_SC_NPROCESSORS_ONLN);
+	u32 processor_count = online > 0 ? (u32)online : 1;
+	if (processor_count > CPU_MAX_LOGICAL_PROCESSORS)
+	{
+		processor_count = CPU_MAX_LOGICAL_PROCESSORS;
+	}
+	fill_flat_topology(topology, processor_count);
+
+	char path[128];
+	char text[256];
+	u32 core_count = 0;
+	u32 cache_domain_count = 0;
+	u64 seen_processors = 0;
+	for (u32 processor = 0; processor < CPU_MAX_LOGICAL_PROCESSORS; ++processor)
+	{
+		if (seen_processors & (1ull << processor))
+		{
+			continue;
+		}
+
+		snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/topology/thread_siblings_list", processor);
+		if (!read_sysfs_file(path, text, sizeof(text)))
+		{
+			continue;
+		}
+
+		CpuCore* core = &topology->cores[core_count++];
+		core->processor_mask = parse_processor_list(text);
+		core->processor_mask |= 1ull << processor;
+		core->cache_domain = 0;
+		core->efficiency_class = 0;
+		seen_processors |= core->processor_mask;
+
+		// Cache indices are in level order, the last unified one is the shared cache.
+		for (u32 index = 0; index < 8; ++index)
+		{
+			snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cache/index%u/level", processor, index);
+			u32 level = read_sysfs_u32(path);
+			if (level == 0)
+			{
+				break;
+			}
+
+			snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cache/index%u/type", processor, index);
+			if (!read_sysfs_file(path, text, sizeof(text)) || strncmp(text, "Instruction", 11) == 0)
+			{
+				continue;
+			}
+
+			snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cache/index%u/size", processor, index);
+			u32 size = read_sysfs_file(path, text, sizeof(text)) ? parse_cache_size(text) : 0;
+			if (level == 1)
+			{
+				topology->l1_data_size = size;
+				snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cache/index%u/coherency_line_size", processor, index);
+				u32 line_size = read_sysfs_u32(path);
+				if (line_size != 0)
+				{
+					topology->cache_line_size = line_size;
+				}
+			}
+			else if (level == 2)
+			{
+				topology->l2_size = size;
+			}
+			else if (level == 3)
+			{
+				snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cache/index%u/shared_cpu_list", processor, index);
+				u64 mask = read_sysfs_file(path, text, sizeof(text)) ? parse_processor_list(text) : 0;
+
+				u32 domain = 0;
+				while (domain < cache_domain_count && topology->cache_domains[domain].processor_mask != mask)
+				{
+					domain++;
+				}
+				if (domain == cache_domain_count && cache_domain_count < CPU_MAX_CACHE_DOMAINS)
+				{
+					topology->cache_domains[cache_domain_count].processor_mask = mask;
+					topology->cache_domains[cache_domain_count].size = size;
+					cache_domain_count++;
+				}
+				core->cache_domain = domain < cache_domain_count ? domain : 0;
+			}
+		}
+	}
+
+	if (core_count == 0)
+	{
+		return false;
+	}
+
+	topology->core_count = core_count;
+	if (cache_domain_count > 0)
+	{
+		topology->cache_domain_count = cache_domain_count;
+	}
+	return true;
+}
+
+// Events.
+struct PosixEvent
+{
+	pthread_mutex_t mutex;
+	pthread_cond_t condition;
+	bool signaled;
+};
+
+bool create_event(PlatformEvent* event)
+{
+	PosixEvent* posix_event = (PosixEvent*)malloc(sizeof(PosixEvent));
+	pthread_mutex_init(&posix_event->mutex, nullptr);
+
+	// Use the monotonic clock for timeouts so they aren't affected by wall clock changes.
+	pthread_condattr_t attributes;
+	pthread_condattr_init(&attributes);
+	pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+	pthread_cond_init(&posix_event->condition, &attributes);
+	pthread_condattr_destroy(&attributes);
+
+	posix_event->signaled = false;
+	event->handle = posix_event;
+	return true;
+}
+
+void destroy_event(PlatformEvent* event)
+{
+	PosixEvent* posix_event = (PosixEvent*)event->handle;
+	pthread_cond_destroy(&posix_event->condition);
+	pthread_mutex_destroy(&posix_event->mutex);
+	free(posix_event);
+	event->handle = nullptr;
+}
+
+void signal_event(PlatformEvent* event)
+{
+	PosixEvent* posix_event = (PosixEvent*)event->handle;
+	pthread_mutex_lock(&posix_event->mutex);
+	posix_event->signaled = true;
+	pthread_cond_signal(&posix_event->condition);
+	pthread_mutex_unlock(&posix_event->mutex);
+}
+
+bool wait_for_event(PlatformEvent* event, u32 timeout_ms)
+{
+	PosixEvent* posix_event = (PosixEvent*)event->handle;
+
+	timespec deadline;
+	clock_gettime(CLOCK_MONOTONIC, &deadline);
+	deadline.tv_sec += timeout_ms / 1000;
+	deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000;
+	if (deadline.tv_nsec >= 1000000000)
+	{
+		deadline.tv_sec++;
+		deadline.tv_nsec -= 1000000000;
+	}
+
+	pthread_mutex_lock(&posix_event->mutex);
+	while (!posix_event->signaled)
+	{
+		if (pthread_cond_timedwait(&posix_event->condition, &posix_event->mutex, &deadline) == ETIMEDOUT)
+		{
+			break;
+		}
+	}
+	bool signaled = posix_event->signaled;
+	posix_event->signaled = false;
+	pthread_mutex_unlock(&posix_event->mutex);
+
+	return signaled;
+}
+
+// Console output.
+void write_console(const char* message, u64 length, ConsoleColor color)
+{
+	// ANSI escape codes matching the Win32 console attributes.
+	static const char* colors[6] = { "\x1b[41m", "\x1b[31m", "\x1b[33m", "\x1b[32m", "\x1b[34m", "\x1b[90m" };
+	static const char* reset = "\x1b[0m";
+
+	bool use_color = isatty(STDOUT_FILENO);
+	if (use_color)
+	{
+		write(STDOUT_FILENO, colors[(u8)color], strlen(colors[(u8)color]));
+	}
+
+	while (length > 0)
+	{
+		ssize_t written = write(STDOUT_FILENO, message, length);
+		if (written <= 0)
+		{
+			break;
+		}
+		message += written;
+		length -= written;
+	}
+
+	if (use_color)
+	{
+		write(STDOUT_FILENO, reset, strlen(reset));
+	}
+}
+
+void write_debug_output(const char* message)
+{
+	// There is no debugger output channel, the console already has the message.
+}
+
+// Memory-mapped files.
+bool create_mapped_file(PlatformMappedFile* file, const char* path, u64 size)
+{
+	*file = {};
+
+	int descriptor = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (descriptor < 0)
+	{
+		return false;
+	}
+
+	if (ftruncate(descriptor, (off_t)size) != 0)
+	{
+		close(descriptor);
+		return false;
+	}
+
+	void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+	if (data == MAP_FAILED)
+	{
+		close(descriptor);
+		return false;
+	}
+
+	file->file_handle = (void*)(intptr_t)descriptor;
+	file->data = (u8*)data;
+	file->size = size;
+	return true;
+}
+
+void close_mapped_file(PlatformMappedFile* file, u64 used_size)
+{
+	if (file->data == nullptr)
+	{
+		return;
+	}
+
+	int descriptor = (int)(intptr_t)file->file_handle;
+	munmap(file->data, file->size);
+	ftruncate(descriptor, (off_t)used_size);
+	close(descriptor);
+
+	*file = {};
+}
+
+bool open_mapped_file(PlatformMappedFile* file, const char* path, MappedFileAccess access, bool huge_pages)
+{
+	*file = {};
+
+	int descriptor = open(path, O_RDONLY | O_CLOEXEC);
+	if (descriptor < 0)
+	{
+		return false;
+	}
+
+	struct stat info;
+	if (fstat(descriptor, &info) != 0 || info.st_size == 0)
+	{
+		close(descriptor);
+		return false;
+	}
+
+	// The mapping keeps its own reference to the file.
+	u64 size = (u64)info.st_size;
+	void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+	close(descriptor);
+	if (data == MAP_FAILED)
+	{
+		return false;
+	}
+
+	if (access == MappedFileAccess::MAPPED_FILE_ACCESS_SEQUENTIAL)
+	{
+		madvise(data, size, MADV_SEQUENTIAL);
+	}
+	else if (access == MappedFileAccess::MAPPED_FILE_ACCESS_RANDOM)
+	{
+		madvise(data, size, MADV_RANDOM);
+	}
+
+#ifdef MADV_HUGEPAGE
+	if (huge_pages)
+	{
+		madvise(data, size, MADV_HUGEPAGE);
+	}
+#endif
+
+	file->data = (u8*)data;
+	file->size = size;
+	return true;
+}
+
+void unmap_file(PlatformMappedFile* file)
+{
+	if (file->data != nullptr)
+	{
+		munmap(file->data, file->size);
+	}
+	*file = {};
+}
+
+void prefetch_mapped_file(PlatformMappedFile* file, u64 offset, u64 size)
+{
+	if (offset >= file->size)
+	{
+		return;
+	}
+	if (size > file->size - offset)
+	{
+		size = file->size - offset;
+	}
+
+	void* address = file->data + offset;
+	align_to_pages(&address, &size);
+	madvise(address, size, MADV_WILLNEED);
+}
+
+// Files.
+bool get_file_size(const char* path, u64* size)
+{
+	struct stat info;
+	if (stat(path, &info) != 0)
+	{
+		return false;
+	}
+
+	*size = (u64)info.st_size;
+	return true;
+}
+
+bool read_file(const char* path, void* buffer, u64 buffer_size, u64* bytes_read)
+{
+	*bytes_read = 0;
+
+	int descriptor = open(path, O_RDONLY);
+	if (descriptor < 0)
+	{
+		return false;
+	}
+
+	u8* dest = (u8*)buffer;
+	while (*bytes_read < buffer_size)
+	{
+		ssize_t read_size = read(descriptor, dest + *bytes_read, buffer_size - *bytes_read);
+		if (read_size < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		if (read_size < 0)
+		{
+			close(descriptor);
+			return false;
+		}
+		if (read_size == 0)
+		{
+			break;
+		}
+		*bytes_read += (u64)read_size;
+	}
+
+	close(descriptor);
+	return true;
+}
+
+bool write_file(const char* path, const void* data, u64 size)
+{
+	int descriptor = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (descriptor < 0)
+	{
+		return false;
+	}
+
+	const u8* src = (const u8*)data;
+	u64 written_total = 0;
+	while (written_total < size)
+	{
+		ssize_t written = write(descriptor, src + written_total, size - written_total);
+		if (written < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		if (written <= 0)
+		{
+			close(descriptor);
+			return false;
+		}
+		written_total += (u64)written;
+	}
+
+	close(descriptor);
+	return true;
+}
+
+#endif // PLATFORM_LINUX
\ No newline at end of file
@@ -0,0 +1,62 @@
+#include "core/platform/platform.h"
+
+#if PLATFORM_LINUX
+
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+// There is no window system backend yet, so windows are headless. Input only
+// comes from a replay, and Ctrl+C or SIGTERM stand in for closing the window.
+static volatile sig_atomic_t quit_requested = 0;
+
+static void handle_quit_signal(int signal_number)
+{
+	quit_requested = 1;
+}
+
+bool create_window(PlatformWindow* window, const char* title, u32 pos_x, u32 pos_y, u32 client_width, u32 client_height)
+{
+	*window = {};
+
+	struct sigaction action = {};
+	action.sa_handler = handle_quit_signal;
+	sigemptyset(&action.sa_mask);
+	sigaction(SIGINT, &action, nullptr);
+	sigaction(SIGTERM, &action, nullptr);
+
+	window->handle = nullptr;
+	window->client_width = client_width;
+	window->client_height = client_height;
+	return true;
+}
+
+void destroy_window(PlatformWindow* window)
+{
+	*window = {};
+}
+
+void set_window_title(PlatformWindow* window, const char* title)
+{
+	// The title carries the debug stats, so print it instead.
+	char line[1024];
+	int length = snprintf(line, sizeof(line), "%s\n", title);
+	if (length > 0)
+	{
+		write(STDOUT_FILENO, line, ((u32)length < sizeof(line)) ? (u32)length : (u32)sizeof(line) - 1);
+	}
+}
+
+void get_window_client_size(PlatformWindow* window, u32* width, u32* height)
+{
+	*width = window->client_width;
+	*height = window->client_height;
+}
+
+bool pump_messages()
+{
+	return quit_requested == 0;
+}
+
+#endif // PLATFORM_LINUX
\ No newline at end of file
@@ -0,0 +1,239 @@
+#include "core/platform/platform.h"
+
+#if PLATFORM_WINDOWS
+
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+// Every file is opened for overlapped I/O and bound to one completion port, so a
+// single GetQueuedCompletionStatusEx call collects a whole batch of completions.
+#define ASYNC_IO_MAX_COMPLETIONS_PER_POLL 64
+
+struct AsyncReadSlot
+{
+	// First so a completion's OVERLAPPED pointer is also the slot.
+	OVERLAPPED overlapped;
+	AsyncFileRead* read;
+	HANDLE file;
+};
+
+struct AsyncIo
+{
+	bool initialized;
+	HANDLE port;
+	AsyncReadSlot* slots;
+	u32 slot_count;
+	u32 in_flight;
+};
+
+static AsyncIo async_io = {};
+
+static void finish_read(AsyncReadSlot* slot, bool succeeded)
+{
+	AsyncFileRead* read = slot->read;
+	CloseHandle(slot->file);
+	*slot = {};
+	async_io.in_flight--;
+
+	read->status = succeeded ? AsyncReadStatus::ASYNC_READ_STATUS_COMPLETE : AsyncReadStatus::ASYNC_READ_STATUS_FAILED;
+	if (read->callback)
+	{
+		read->callback(read);
+	}
+}
+
+// Issues a read for the rest of the buffer. ReadFile takes a DWORD length, so
+// large reads go out in pieces.
+static void issue_read(AsyncReadSlot* slot)
+{
+	AsyncFileRead* read = slot->read;
+	u64 remaining = read->buffer_size - read->bytes_read;
+	u64 offset = read->offset + read->bytes_read;
+
+	memset(&slot->overlapped, 0, sizeof(slot->overlapped));
+	slot->overlapped.Offset = (DWORD)offset;
+	slot->overlapped.OffsetHigh = (DWORD)(offset >> 32);
+
+	DWORD size = remaining > 0x7FFFF000 ? 0x7FFFF000 : (DWORD)remaining;
+	if (!ReadFile(slot->file, (u8*)read->buffer + read->bytes_read, size, nullptr, &slot->overlapped))
+	{
+		// No completion is queued when ReadFile fails outright.
+		DWORD error = GetLastError();
+		if (error != ERROR_IO_PENDING)
+		{
+			finish_read(slot, error == ERROR_HANDLE_EOF);
+		}
+	}
+}
+
+static void handle_completion(AsyncReadSlot* slot)
+{
+	AsyncFileRead* read = slot->read;
+
+	DWORD transferred = 0;
+	if (!GetOverlappedResult(slot->file, &slot->overlapped, &transferred, FALSE))
+	{
+		finish_read(slot, GetLastError() == ERROR_HANDLE_EOF);
+		return;
+	}
+
+	read->bytes_read += transferred;
+	if (transferred > 0 && read->bytes_read < read->buffer_size)
+	{
+		issue_read(slot);
+		return;
+	}
+
+	finish_read(slot, true);
+}
+
+// Returns how many reads finished.
+static u32 process_completions(DWORD timeout_ms)
+{
+	OVERLAPPED_ENTRY entries[ASYNC_IO_MAX_COMPLETIONS_PER_POLL];
+	ULONG entry_count = 0;
+	if (!GetQueuedCompletionStatusEx(async_io.port, entries, ASYNC_IO_MAX_COMPLETIONS_PER_POLL, &entry_count, timeout_ms, FALSE))
+	{
+		return 0;
+	}
+
+	u32 in_flight = async_io.in_flight;
+	for (ULONG i = 0; i < entry_count; ++i)
+	{
+		handle_completion((AsyncReadSlot*)entries[i].lpOverlapped);
+	}
+	return in_flight - async_io.in_flight;
+}
+
+bool initialize_async_io(u32 queue_depth)
+{
+	shutdown_async_io();
+
+	async_io.port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1);
+	if (async_io.port == nullptr)
+	{
+		return false;
+	}
+
+	async_io.slots = (AsyncReadSlot*)calloc(queue_depth, sizeof(AsyncReadSlot));
+	if (async_io.slots == nullptr)
+	{
+		CloseHandle(async_io.port);
+		async_io.port = nullptr;
+		return false;
+	}
+	async_io.slot_count = queue_depth;
+	async_io.initialized = true;
+	return true;
+}
+
+void shutdown_async_io()
+{
+	if (!async_io.initialized)
+	{
+		return;
+	}
+
+	// The OS may still be writing into caller buffers.
+	u64 start = get_performance_counter();
+	u64 timeout_ticks = get_performance_frequency() * ASYNC_IO_SHUTDOWN_TIMEOUT_MS / 1000;
+	while (async_io.in_flight > 0)
+	{
+		u64 elapsed = get_performance_counter() - start;
+		if (elapsed >= timeout_ticks)
+		{
+			async_io = {};
+			return;
+		}
+		process_completions((DWORD)((timeout_ticks - elapsed) * 1000 / get_performance_frequency()) + 1);
+	}
+
+	CloseHandle(async_io.port);
+	free(async_io.slots);
+	async_io = {};
+}
+
+u32 submit_async_reads(AsyncFileRead* reads, u32 count)
+{
+	u32 submitted = 0;
+	u32 slot_index = 0;
+	for (; submitted < count; ++submitted)
+	{
+		while (slot_index < async_io.slot_count && async_io.slots[slot_index].read != nullptr)
+		{
+			slot_index++;
+		}
+		if (slot_index == async_io.slot_count)
+		{
+			break;
+		}
+
+		AsyncFileRead* read = &reads[submitted];
+		read->bytes_read = 0;
+		read->slot = slot_index;
+		read->status = AsyncReadStatus::ASYNC_READ_STATUS_PENDING;
+
+		wchar_t wide_path[MAX_PATH];
+		HANDLE file = INVALID_HANDLE_VALUE;
+		if (MultiByteToWideChar(CP_UTF8, 0, read->path, -1, wide_path, MAX_PATH) > 0)
+		{
+			file = CreateFileW(wide_path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_OVERLAPPED | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		}
+		if (file == INVALID_HANDLE_VALUE || CreateIoCompletionPort(file, async_io.port, 0, 0) == nullptr)
+		{
+			if (file != INVALID_HANDLE_VALUE)
+			{
+				CloseHandle(file);
+			}
+			read->status = AsyncReadStatus::ASYNC_READ_STATUS_FAILED;
+			if (read->callback)
+			{
+				read->callback(read);
+			}
+			continue;
+		}
+
+		AsyncReadSlot* slot = &async_io.slots[slot_index];
+		slot->read = read;
+		slot->file = file;
+		async_io.in_flight++;
+		issue_read(slot);
+	}
+	return submitted;
+}
+
+u32 poll_async_reads()
+{
+	if (async_io.in_flight == 0)
+	{
+		return 0;
+	}
+	return process_completions(0);
+}
+
+bool wait_for_async_read(AsyncFileRead* read, u32 timeout_ms)
+{
+	u64 start = get_performance_counter();
+	u64 timeout_ticks = get_performance_frequency() * timeout_ms / 1000;
+	for (;;)
+	{
+		if (read->status != AsyncReadStatus::ASYNC_READ_STATUS_PENDING)
+		{
+			return read->status == AsyncReadStatus::ASYNC_READ_STATUS_COMPLETE;
+		}
+
+		u64 elapsed = get_performance_counter() - start;
+		if (elapsed >= timeout_ticks)
+		{
+			return false;
+		}
+
+		DWORD remaining_ms = (DWORD)((timeout_ticks - elapsed) * 1000 / get_performance_frequency());
+		process_completions(remaining_ms > 0 ? remaining_ms : 1);
+	}
+}
+
+#endif
\ No newline at end of file
@@ -2,12 +2,517 @@
 
 #if PLATFORM_WINDOWS
 
-// TODO: define window lean and mean or whatever...
+#define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
 
-void* copy_memory(void* dest, const void* src, size_t size)
+#include <stdlib.h>
+
+// Virtual memory.
+u64 get_page_size()
+{
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwPageSize;
+}
+
+u64 get_large_page_size()
+{
+	return GetLargePageMinimum();
+}
+
+// MEM_LARGE_PAGES fails unless the process token has SeLockMemoryPrivilege enabled,
+// it is granted by the "Lock pages in memory" policy but starts out disabled.
+static bool enable_lock_memory_privilege()
+{
+	static s32 enabled = -1;
+	if (enabled >= 0)
+	{
+		return enabled != 0;
+	}
+
+	enabled = 0;
+	HANDLE token;
+	if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token))
+	{
+		return false;
+	}
+
+	TOKEN_PRIVILEGES privileges = {};
+	privileges.PrivilegeCount = 1;
+	privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+	if (LookupPrivilegeValueW(nullptr, L"SeLockMemoryPrivilege", &privileges.Privileges[0].Luid))
+	{
+		// AdjustTokenPrivileges succeeds even when the privilege isn't held.
+		AdjustTokenPrivileges(token, FALSE, &privileges, 0, nullptr, nullptr);
+		enabled = GetLastError() == ERROR_SUCCESS ? 1 : 0;
+	}
+
+	CloseHandle(token);
+	return enabled != 0;
+}
+
+void* reserve_memory(u64 size, bool large_pages)
+{
+	u64 large_page_size = get_large_page_size();
+	if (large_pages && large_page_size != 0 && size % large_page_size == 0 && enable_lock_memory_privilege())
+	{
+		// Large pages can't be committed separately, the whole range is committed here.
+		void* address = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+		if (address != nullptr)
+		{
+			return address;
+		}
+	}
+
+	return VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+}
+
+bool commit_memory(void* address, u64 size)
+{
+	// Committing pages that are already committed (including large pages) is allowed.
+	return VirtualAlloc(address, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+}
+
+void decommit_memory(void* address, u64 size)
+{
+	// Large pages can't be decommitted, this fails harmlessly for them.
+	VirtualFree(address, size, MEM_DECOMMIT);
+}
+
+void release_memory(void* address, u64 size)
+{
+	VirtualFree(address, 0, MEM_RELEASE);
+}
+
+// Timing.
+u64 get_performance_counter()
+{
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return counter.QuadPart;
+}
+
+u64 get_performance_frequency()
+{
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	return frequency.QuadPart;
+}
+
+// Threads.
+static DWORD WINAPI win32_thread_entry(LPVOID param)
+{
+	PlatformThread* thread = (PlatformThread*)param;
+	return thread->proc(thread->data);
+}
+
+bool create_thread(PlatformThread* thread, ThreadProc proc, void* data, const char* name)
+{
+	thread->proc = proc;
+	thread->data = data;
+
+	DWORD id = 0;
+	thread->handle = CreateThread(nullptr, 0, win32_thread_entry, thread, 0, &id);
+	thread->id = id;
+	if (thread->handle == nullptr)
+	{
+		return false;
+	}
+
+	if (name)
+	{
+		set_thread_name(thread, name);
+	}
+	return true;
+}
+
+bool join_thread(PlatformThread* thread, u32 timeout_ms)
+{
+	if (WaitForSingleObject((HANDLE)thread->handle, timeout_ms) != WAIT_OBJECT_0)
+	{
+		return false;
+	}
+
+	CloseHandle((HANDLE)thread->handle);
+	thread->handle = nullptr;
+	return true;
+}
+
+void yield_thread()
+{
+	SwitchToThread();
+}
+
+static HANDLE get_thread_handle(PlatformThread* thread)
+{
+	return thread ? (HANDLE)thread->handle : GetCurrentThread();
+}
+
+void set_thread_name(PlatformThread* thread, const char* name)
+{
+	wchar_t wide_name[64];
+	if (MultiByteToWideChar(CP_UTF8, 0, name, -1, wide_name, 64) > 0)
+	{
+		SetThreadDescription(get_thread_handle(thread), wide_name);
+	}
+}
+
+bool set_thread_affinity(PlatformThread* thread, u64 processor_mask)
+{
+	return SetThreadAffinityMask(get_thread_handle(thread), (DWORD_PTR)processor_mask) != 0;
+}
+
+bool set_thread_priority(PlatformThread* thread, ThreadPriority priority)
+{
+	static const int priorities[] =
+	{
+		THREAD_PRIORITY_LOWEST,
+		THREAD_PRIORITY_BELOW_NORMAL,
+		THREAD_PRIORITY_NORMAL,
+		THREAD_PRIORITY_HIGHEST,
+		THREAD_PRIORITY_TIME_CRITICAL
+	};
+	return SetThreadPriority(get_thread_handle(thread), priorities[(u32)priority]) != 0;
+}
+
+u32 get_current_processor()
+{
+	return GetCurrentProcessorNumber();
+}
+
+// CPU topology.
+static void fill_flat_topology(CpuTopology* topology, u32 processor_count)
+{
+	*topology = {};
+	topology->logical_processor_count = processor_count;
+	topology->core_count = processor_count;
+	topology->cache_domain_count = 1;
+	topology->cache_line_size = 64;
+	for (u32 i = 0; i < processor_count; ++i)
+	{
+		topology->cores[i].processor_mask = 1ull << i;
+		topology->cache_domains[0].processor_mask |= 1ull << i;
+	}
+}
+
+bool get_cpu_topology(CpuTopology* topology)
+{
+	u32 processor_count = GetActiveProcessorCount(0);
+	if (processor_count > CPU_MAX_LOGICAL_PROCESSORS)
+	{
+		processor_count = CPU_MAX_LOGICAL_PROCESSORS;
+	}
+	fill_flat_topology(topology, processor_count);
+
+	DWORD size = 0;
+	GetLogicalProcessorInformationEx(RelationAll, nullptr, &size);
+	if (GetLastError() != ERROR_INSUFFICIENT_BUFFER)
+	{
+		return false;
+	}
+
+	u8* buffer = (u8*)malloc(size);
+	if (!GetLogicalProcessorInformationEx(RelationAll, (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*)buffer, &size))
+	{
+		free(buffer);
+		return false;
+	}
+
+	u32 core_count = 0;
+	u32 cache_domain_count = 0;
+	for (DWORD offset = 0; offset < size;)
+	{
+		SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* info = (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*)(buffer + offset);
+		offset += info->Size;
+
+		if (info->Relationship == RelationProcessorCore)
+		{
+			// Only group 0 fits in the masks.
+			if (info->Processor.GroupMask[0].Group == 0 && core_count < CPU_MAX_LOGICAL_PROCESSORS)
+			{
+				CpuCore* core = &topology->cores[core_count++];
+				core->processor_mask = info->Processor.GroupMask[0].Mask;
+				core->cache_domain = 0;
+				core->efficiency_class = info->Processor.EfficiencyClass;
+			}
+		}
+		else if (info->Relationship == RelationCache)
+		{
+			CACHE_RELATIONSHIP* cache = &info->Cache;
+			if (cache->Level == 1 && cache->Type == CacheData)
+			{
+				topology->l1_data_size = cache->CacheSize;
+				topology->cache_line_size = cache->LineSize;
+			}
+			else if (cache->Level == 2)
+			{
+				topology->l2_size = cache->CacheSize;
+			}
+			else if (cache->Level == 3 && cache->GroupMask.Group == 0 && cache_domain_count < CPU_MAX_CACHE_DOMAINS)
+			{
+				CpuCacheDomain* domain = &topology->cache_domains[cache_domain_count++];
+				domain->processor_mask = cache->GroupMask.Mask;
+				domain->size = cache->CacheSize;
+			}
+		}
+	}
+	free(buffer);
+
+	if (core_count > 0)
+	{
+		topology->core_count = core_count;
+	}
+
+	// Without an L3 every processor counts as sharing one domain.
+	if (cache_domain_count > 0)
+	{
+		topology->cache_domain_count = cache_domain_count;
+		for (u32 i = 0; i < core_count; ++i)
+		{
+			for (u32 j = 0; j < cache_domain_count; ++j)
+			{
+				if (topology->cores[i].processor_mask & topology->cache_domains[j].processor_mask)
+				{
+					topology->cores[i].cache_domain = j;
+					break;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+// Events.
+bool create_event(PlatformEvent* event)
+{
+	event->handle = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+	return event->handle != nullptr;
+}
+
+void destroy_event(PlatformEvent* event)
+{
+	CloseHandle((HANDLE)event->handle);
+	event->handle = nullptr;
+}
+
+void signal_event(PlatformEvent* event)
+{
+	SetEvent((HANDLE)event->handle);
+}
+
+bool wait_for_event(PlatformEvent* event, u32 timeout_ms)
+{
+	return WaitForSingleObject((HANDLE)event->handle, timeout_ms) == WAIT_OBJECT_0;
+}
+
+// Console output.
+void write_console(const char* message, u64 length, ConsoleColor color)
+{
+	static const WORD attributes[6] = { 64, 4, 6, 2, 1, 8 };
+
+	HANDLE console_handle = GetStdHandle(STD_OUTPUT_HANDLE);
+	SetConsoleTextAttribute(console_handle, attributes[(u8)color]);
+	DWORD number_written = 0;
+	WriteConsoleA(console_handle, message, (DWORD)length, &number_written, 0);
+}
+
+void write_debug_output(const char* message)
+{
+	OutputDebugStringA(message);
+}
+
+// Memory-mapped files.
+bool create_mapped_file(PlatformMappedFile* file, const char* path, u64 size)
 {
-	return memcpy(dest, src, size);
+	*file = {};
+
+	HANDLE file_handle = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file_handle == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	// Creating the mapping grows the file to the requested size.
+	HANDLE mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READWRITE, (DWORD)(size >> 32), (DWORD)(size & 0xFFFFFFFF), nullptr);
+	if (mapping_handle == nullptr)
+	{
+		CloseHandle(file_handle);
+		return false;
+	}
+
+	void* data = MapViewOfFile(mapping_handle, FILE_MAP_WRITE, 0, 0, (SIZE_T)size);
+	if (data == nullptr)
+	{
+		CloseHandle(mapping_handle);
+		CloseHandle(file_handle);
+		return false;
+	}
+
+	file->file_handle = file_handle;
+	file->mapping_handle = mapping_handle;
+	file->data = (u8*)data;
+	file->size = size;
+	return true;
+}
+
+void close_mapped_file(PlatformMappedFile* file, u64 used_size)
+{
+	if (file->data == nullptr)
+	{
+		return;
+	}
+
+	UnmapViewOfFile(file->data);
+	CloseHandle((HANDLE)file->mapping_handle);
+
+	LARGE_INTEGER end;
+	end.QuadPart = (LONGLONG)used_size;
+	SetFilePointerEx((HANDLE)file->file_handle, end, nullptr, FILE_BEGIN);
+	SetEndOfFile((HANDLE)file->file_handle);
+	CloseHandle((HANDLE)file->file_handle);
+
+	*file = {};
+}
+
+bool open_mapped_file(PlatformMappedFile* file, const char* path, MappedFileAccess access, bool huge_pages)
+{
+	*file = {};
+
+	DWORD flags = FILE_ATTRIBUTE_NORMAL;
+	if (access == MappedFileAccess::MAPPED_FILE_ACCESS_SEQUENTIAL)
+	{
+		flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+	}
+	else if (access == MappedFileAccess::MAPPED_FILE_ACCESS_RANDOM)
+	{
+		flags |= FILE_FLAG_RANDOM_ACCESS;
+	}
+
+	HANDLE file_handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr);
+	if (file_handle == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file_handle, &size) || size.QuadPart == 0)
+	{
+		CloseHandle(file_handle);
+		return false;
+	}
+
+	HANDLE mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	void* data = mapping_handle ? MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+
+	// The view keeps the mapping and the file open.
+	if (mapping_handle)
+	{
+		CloseHandle(mapping_handle);
+	}
+	CloseHandle(file_handle);
+	if (data == nullptr)
+	{
+		return false;
+	}
+
+	file->data = (u8*)data;
+	file->size = (u64)size.QuadPart;
+	return true;
+}
+
+void unmap_file(PlatformMappedFile* file)
+{
+	if (file->data != nullptr)
+	{
+		UnmapViewOfFile(file->data);
+	}
+	*file = {};
+}
+
+void prefetch_mapped_file(PlatformMappedFile* file, u64 offset, u64 size)
+{
+	if (offset >= file->size)
+	{
+		return;
+	}
+
+	WIN32_MEMORY_RANGE_ENTRY range;
+	range.VirtualAddress = file->data + offset;
+	range.NumberOfBytes = (SIZE_T)(size < file->size - offset ? size : file->size - offset);
+	PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+}
+
+// Files.
+bool get_file_size(const char* path, u64* size)
+{
+	WIN32_FILE_ATTRIBUTE_DATA attributes;
+	if (!GetFileAttributesExA(path, GetFileExInfoStandard, &attributes))
+	{
+		return false;
+	}
+
+	*size = ((u64)attributes.nFileSizeHigh << 32) | attributes.nFileSizeLow;
+	return true;
+}
+
+bool read_file(const char* path, void* buffer, u64 buffer_size, u64* bytes_read)
+{
+	*bytes_read = 0;
+
+	HANDLE file_handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file_handle == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	// ReadFile takes a 32-bit size, so read in chunks.
+	u8* dest = (u8*)buffer;
+	while (*bytes_read < buffer_size)
+	{
+		u64 remaining = buffer_size - *bytes_read;
+		DWORD chunk = (remaining > 0x40000000) ? 0x40000000 : (DWORD)remaining;
+		DWORD read = 0;
+		if (!ReadFile(file_handle, dest + *bytes_read, chunk, &read, nullptr))
+		{
+			CloseHandle(file_handle);
+			return false;
+		}
+		if (read == 0)
+		{
+			break;
+		}
+		*bytes_read += read;
+	}
+
+	CloseHandle(file_handle);
+	return true;
+}
+
+bool write_file(const char* path, const void* data, u64 size)
+{
+	HANDLE file_handle = CreateFileA(path, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file_handle == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	const u8* src = (const u8*)data;
+	u64 written_total = 0;
+	while (written_total < size)
+	{
+		u64 remaining = size - written_total;
+		DWORD chunk = (remaining > 0x40000000) ? 0x40000000 : (DWORD)remaining;
+		DWORD written = 0;
+		if (!WriteFile(file_handle, src + written_total, chunk, &written, nullptr) || written == 0)
+		{
+			CloseHandle(file_handle);
+			return false;
+		}
+		written_total += written;
+	}
+
+	CloseHandle(file_handle);
+	return true;
 }
 
 #endif // PLATFORM_WINDOWS
\ No newline at end of file
@@ -0,0 +1,214 @@
+#include "core/platform/platform.h"
+
+#if PLATFORM_WINDOWS
+
+#include "core/input.h"
+#include "core/logger.h"
+
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#include <windowsx.h>
+
+static LRESULT CALLBACK WindowProc(HWND window, UINT message, WPARAM w_param, LPARAM l_param)
+{
+	switch (message)
+	{
+	case WM_DESTROY:
+	{
+		PostQuitMessage(0);
+		return 0;
+	}
+	case WM_KEYDOWN:
+	case WM_SYSKEYDOWN:
+	case WM_KEYUP:
+	case WM_SYSKEYUP:
+	{
+		// TODO: We need to handle repeat key down messages when holding a key. Currently we just do 
+		// nothing about it. We should add proper handling at some point.
+		bool pressed = (message == WM_KEYDOWN || message == WM_SYSKEYDOWN);
+		Key key = (Key)w_param;
+		process_key(key, pressed);
+		break;
+	}
+	case WM_MOUSEMOVE:
+	{
+		s32 x_pos = GET_X_LPARAM(l_param);
+		s32 y_pos = GET_Y_LPARAM(l_param);
+		process_mouse_move(x_pos, y_pos);
+		break;
+	}
+	case WM_LBUTTONDOWN:
+	case WM_MBUTTONDOWN:
+	case WM_RBUTTONDOWN:
+	case WM_LBUTTONUP:
+	case WM_MBUTTONUP:
+	case WM_RBUTTONUP:
+	{
+		bool pressed = (message == WM_LBUTTONDOWN || message == WM_MBUTTONDOWN || message == WM_RBUTTONDOWN);
+		Button button = Button::BUTTON_MAX_BUTTONS;
+		switch (message)
+		{
+		case WM_LBUTTONDOWN:
+		case WM_LBUTTONUP:
+		{
+			button = Button::BUTTON_LEFT;
+			break;
+		}
+		case WM_MBUTTONDOWN:
+		case WM_MBUTTONUP:
+		{
+			button = Button::BUTTON_MIDDLE;
+			break;
+		}
+		case WM_RBUTTONDOWN:
+		case WM_RBUTTONUP:
+		{
+			button = Button::BUTTON_RIGHT;
+			break;
+		}
+		}
+
+		if (button != Button::BUTTON_MAX_BUTTONS)
+		{
+			process_button(button, pressed);
+		}
+		break;
+	}
+	case WM_MOUSEWHEEL:
+	{
+		// Pass the raw delta through, high resolution wheels send less than a notch at a time.
+		s32 z_delta = GET_WHEEL_DELTA_WPARAM(w_param);
+		if (z_delta != 0)
+		{
+			process_mouse_wheel(z_delta);
+		}
+		break;
+	}
+	case WM_INPUT:
+	{
+		RAWINPUT raw_input;
+		UINT size = sizeof(raw_input);
+		if (GetRawInputData((HRAWINPUT)l_param, RID_INPUT, &raw_input, &size, sizeof(RAWINPUTHEADER)) != (UINT)-1 &&
+			raw_input.header.dwType == RIM_TYPEMOUSE &&
+			!(raw_input.data.mouse.usFlags & MOUSE_MOVE_ABSOLUTE))
+		{
+			s32 x_delta = raw_input.data.mouse.lLastX;
+			s32 y_delta = raw_input.data.mouse.lLastY;
+			if (x_delta != 0 || y_delta != 0)
+			{
+				process_mouse_delta(x_delta, y_delta);
+			}
+		}
+		// DefWindowProc still has to run for WM_INPUT so the system can clean up.
+		break;
+	}
+	}
+	return DefWindowProcW(window, message, w_param, l_param);
+}
+
+bool create_window(PlatformWindow* window, const char* title, u32 pos_x, u32 pos_y, u32 client_width, u32 client_height)
+{
+	*window = {};
+
+	WNDCLASSEXW window_class = {};
+	window_class.cbSize = sizeof(window_class);
+	window_class.lpfnWndProc = &WindowProc;
+	window_class.hInstance = GetModuleHandleW(nullptr);
+	window_class.hIcon = LoadIconW(nullptr, (LPCWSTR)IDI_APPLICATION);
+	window_class.hbrBackground = (HBRUSH)GetStockObject(BLACK_BRUSH);
+	window_class.lpszClassName = L"d3d12_renderer";
+
+	ATOM Atom = RegisterClassExW(&window_class);
+	Assert(Atom);
+
+	DWORD window_ex_style = WS_EX_APPWINDOW; //| WS_EX_NOREDIRECTIONBITMAP; // magic style to make DXGI_SWAP_EFFECT_FLIP_DISCARD not glitch on window resizing
+	DWORD window_style = WS_OVERLAPPEDWINDOW;
+
+	// Obtain the size of the border.
+	RECT border_rect = { 0, 0, 0, 0 };
+	AdjustWindowRectEx(&border_rect, window_style, 0, window_ex_style);
+
+	u32 window_pos_x = pos_x;
+	u32 window_pos_y = pos_y;
+	u32 window_width = client_width;
+	u32 window_height = client_height;
+
+	// In this case, the border rectangle is negative.
+	window_pos_x += border_rect.left;
+	window_pos_y += border_rect.top;
+
+	// Grow by the size of the OS border.
+	window_width += border_rect.right - border_rect.left;
+	window_height += border_rect.bottom - border_rect.top;
+
+	WCHAR wide_title[256];
+	MultiByteToWideChar(CP_UTF8, 0, title, -1, wide_title, 256);
+
+	HWND handle = CreateWindowExW(
+		window_ex_style, window_class.lpszClassName, wide_title, window_style,
+		window_pos_x, window_pos_y, window_width, window_height,
+		nullptr, nullptr, window_class.hInstance, nullptr);
+	Assert(handle);
+
+	// Raw mouse motion arrives at the device rate as WM_INPUT, unaffected by
+	// pointer acceleration or the screen edges.
+	RAWINPUTDEVICE mouse_device = {};
+	mouse_device.usUsagePage = 0x01; // HID_USAGE_PAGE_GENERIC
+	mouse_device.usUsage = 0x02;     // HID_USAGE_GENERIC_MOUSE
+	mouse_device.dwFlags = 0;
+	mouse_device.hwndTarget = handle;
+	if (!RegisterRawInputDevices(&mouse_device, 1, sizeof(mouse_device)))
+	{
+		LOG_CAT_WARN(PLATFORM, "Failed to register for raw mouse input, mouse deltas will come from cursor movement.");
+	}
+
+	ShowWindow(handle, SW_SHOWDEFAULT);
+
+	window->handle = handle;
+	window->client_width = client_width;
+	window->client_height = client_height;
+	return true;
+}
+
+void destroy_window(PlatformWindow* window)
+{
+	if (window->handle && IsWindow((HWND)window->handle))
+	{
+		DestroyWindow((HWND)window->handle);
+	}
+	*window = {};
+}
+
+void set_window_title(PlatformWindow* window, const char* title)
+{
+	WCHAR wide_title[1024];
+	MultiByteToWideChar(CP_UTF8, 0, title, -1, wide_title, 1024);
+	SetWindowTextW((HWND)window->handle, wide_title);
+}
+
+void get_window_client_size(PlatformWindow* window, u32* width, u32* height)
+{
+	RECT rect;
+	GetClientRect((HWND)window->handle, &rect);
+	*width = (u32)(rect.right - rect.left);
+	*height = (u32)(rect.bottom - rect.top);
+}
+
+bool pump_messages()
+{
+	MSG message = {};
+
+	while (PeekMessageW(&message, nullptr, 0, 0, PM_REMOVE))
+	{
+		if (message.message == WM_QUIT)
+		{
+			// Return to main so shutdown can flush the logger before the process exits.
+			return false;
+		}
+		TranslateMessage(&message);
+		DispatchMessageW(&message);
+	}
+	return true;
+}
+
+#endif // PLATFORM_WINDOWS
\ No newline at end of file
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "core/core_types.h"
+
+// Fixed capacity pool of T addressed by 32-bit handles. A handle is a slot index
+// in the low 16 bits and that slot's generation in the high 16 bits. Allocating
+// and freeing a slot both bump its generation, so handles to freed items stop
+// resolving instead of reaching whatever reuses the slot (until the generation
+// wraps after 32768 reuses). Generation 0 is never handed out, which keeps a
+// zeroed handle and never used slots invalid.
+#define POOL_INDEX_BITS 16
+#define POOL_INDEX_MASK ((1u << POOL_INDEX_BITS) - 1)
+#define POOL_INVALID_INDEX 0xFFFF
+
+template <typename T>
+struct Handle
+{
+	u32 value;
+};
+
+template <typename T>
+inline bool operator==(Handle<T> a, Handle<T> b)
+{
+	return a.value == b.value;
+}
+
+template <typename T>
+inline bool operator!=(Handle<T> a, Handle<T> b)
+{
+	return a.value != b.value;
+}
+
+// Items, generations and the free list are separate arrays, so lookups touch
+// one packed u16 for the check and then the item.
+template <typename T, u32 N>
+struct Pool
+{
+	static_assert(N > 0 && N < POOL_INVALID_INDEX, "Pool indices must fit in 16 bits.");
+
+	T items[N];
+	u16 generations[N];
+	u16 next_free[N];
+	u16 free_head;
+	u32 count;
+};
+
+inline u16 next_pool_generation(u16 generation)
+{
+	generation++;
+	return generation != 0 ? generation : 1;
+}
+
+template <typename T, u32 N>
+void initialize_pool(Pool<T, N>* pool)
+{
+	for (u32 i = 0; i < N; ++i)
+	{
+		pool->items[i] = {};
+		pool->generations[i] = 0;
+		pool->next_free[i] = (u16)(i + 1 < N ? i + 1 : POOL_INVALID_INDEX);
+	}
+	pool->free_head = 0;
+	pool->count = 0;
+}
+
+// Returns a zeroed handle when the pool is full. The item is value initialized.
+template <typename T, u32 N>
+Handle<T> allocate_pool_item(Pool<T, N>* pool)
+{
+	u16 index = pool->free_head;
+	if (index == POOL_INVALID_INDEX)
+	{
+		return {};
+	}
+
+	pool->free_head = pool->next_free[index];
+	pool->generations[index] = next_pool_generation(pool->generations[index]);
+	pool->items[index] = {};
+	pool->count++;
+	return { ((u32)pool->generations[index] << POOL_INDEX_BITS) | index };
+}
+
+template <typename T, u32 N>
+bool is_pool_handle_valid(const Pool<T, N>* pool, Handle<T> handle)
+{
+	u32 index = handle.value & POOL_INDEX_MASK;
+	u16 generation = (u16)(handle.value >> POOL_INDEX_BITS);
+	return index < N && generation != 0 && pool->generations[index] == generation;
+}
+
+// nullptr for stale or zeroed handles.
+template <typename T, u32 N>
+T* get_pool_item(Pool<T, N>* pool, Handle<T> handle)
+{
+	return is_pool_handle_valid(pool, handle) ? &pool->items[handle.value & POOL_INDEX_MASK] : nullptr;
+}
+
+// Freeing a stale handle does nothing.
+template <typename T, u32 N>
+void free_pool_item(Pool<T, N>* pool, Handle<T> handle)
+{
+	if (!is_pool_handle_valid(pool, handle))
+	{
+		return;
+	}
+
+	u16 index = (u16)(handle.value & POOL_INDEX_MASK);
+	pool->generations[index] = next_pool_generation(pool->generations[index]);
+	pool->next_free[index] = pool->free_head;
+	pool->free_head = index;
+	pool->count--;
+}
\ No newline at end of file
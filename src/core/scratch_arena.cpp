@@ -0,0 +1,66 @@
+#include "core/scratch_arena.h"
+#include "core/logger.h"
+
+struct ScratchArenas
+{
+	Arena arenas[SCRATCH_ARENA_COUNT];
+
+	~ScratchArenas()
+	{
+		for (u32 i = 0; i < SCRATCH_ARENA_COUNT; ++i)
+		{
+			destroy_arena(&arenas[i]);
+		}
+	}
+};
+
+static thread_local ScratchArenas scratch_arenas;
+
+static const char* scratch_arena_names[SCRATCH_ARENA_COUNT] = { "scratch 0", "scratch 1" };
+
+Arena* get_scratch_arena(const Arena* conflict)
+{
+	for (u32 i = 0; i < SCRATCH_ARENA_COUNT; ++i)
+	{
+		Arena* arena = &scratch_arenas.arenas[i];
+		if (arena == conflict)
+		{
+			continue;
+		}
+
+		// Reserving address space only fails once the process runs out of it.
+		if (arena->base == nullptr && !create_arena(arena, scratch_arena_names[i], SCRATCH_ARENA_RESERVE_SIZE, MEMORY_SITE(SCRATCH)))
+		{
+			LOG_CAT_FATAL(MEMORY, "Failed to reserve the %s arena.", scratch_arena_names[i]);
+			Assert(false);
+		}
+		return arena;
+	}
+
+	Assert(false);
+	return nullptr;
+}
+
+void release_scratch_arenas()
+{
+	for (u32 i = 0; i < SCRATCH_ARENA_COUNT; ++i)
+	{
+		Assert(scratch_arenas.arenas[i].used == 0);
+		destroy_arena(&scratch_arenas.arenas[i]);
+	}
+}
+
+ScratchScope::ScratchScope(const Arena* conflict)
+{
+	arena = get_scratch_arena(conflict);
+	position = get_arena_position(arena);
+}
+
+ScratchScope::~ScratchScope()
+{
+	pop_arena_to(arena, position);
+	if (position == 0 && arena->committed_size > SCRATCH_ARENA_RETAIN_SIZE)
+	{
+		shrink_arena(arena, SCRATCH_ARENA_RETAIN_SIZE);
+	}
+}
\ No newline at end of file
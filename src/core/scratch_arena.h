@@ -0,0 +1,37 @@
+#pragma once
+
+#include "core/arena.h"
+#include "core/core_types.h"
+
+// Temporary memory for the calling thread. Every thread gets SCRATCH_ARENA_COUNT
+// arenas on first use. A ScratchScope remembers where its arena was and rewinds
+// to it when the scope ends, so nested scopes free in reverse order and nothing
+// taken from scratch is ever freed by hand.
+//
+// A function that returns scratch memory to a caller also using scratch must be
+// given the caller's arena to allocate from, and its own ScratchScope should pass
+// that arena as conflict so it picks the other one. Otherwise the callee's rewind
+// would free the caller's result.
+#define SCRATCH_ARENA_COUNT 2
+#define SCRATCH_ARENA_RESERVE_SIZE (256ull * 1024 * 1024)
+// An outermost scope returns committed pages past this to the OS, so one large
+// temporary doesn't pin its pages for the rest of the thread's life.
+#define SCRATCH_ARENA_RETAIN_SIZE (4ull * 1024 * 1024)
+
+// Any of the calling thread's scratch arenas other than conflict.
+Arena* get_scratch_arena(const Arena* conflict = nullptr);
+// Frees the calling thread's scratch arenas. Threads free theirs when they
+// exit, this lets the main thread do it before shutdown checks for leaks.
+void release_scratch_arenas();
+
+struct ScratchScope
+{
+	Arena* arena;
+	u64 position;
+
+	explicit ScratchScope(const Arena* conflict = nullptr);
+	~ScratchScope();
+
+	ScratchScope(const ScratchScope&) = delete;
+	ScratchScope& operator=(const ScratchScope&) = delete;
+};
\ No newline at end of file
@@ -1,13 +1,32 @@
 #include "core/application.h"
+#include "core/heap.h"
+#include "core/jobs.h"
 #include "core/logger.h"
+#include "core/platform/platform.h"
 
+#if PLATFORM_WINDOWS
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
+#endif
 #include <cstdint>
+#include <cstring>
 
 int main(int argc, char** argv)
 {
+    initialize_memory_functions();
+    initialize_clock();
+    // The logger's queue comes from the logging heap.
+    initialize_heaps();
     initialize_logging();
+    LOG_CAT_INFO(PLATFORM, "Using %s memory functions.", get_memory_implementation_name(get_memory_implementation()));
+    LOG_CAT_INFO(PLATFORM, "Using the %s clock at %llu Hz.", is_clock_using_tsc() ? "TSC" : "OS", get_timestamp_frequency());
+
+    set_thread_name(nullptr, "main");
+    initialize_async_io();
+    CpuTopology topology;
+    get_cpu_topology(&topology);
+    LOG_CAT_INFO(PLATFORM, "%u logical processors, %u cores, %u shared cache domains.", topology.logical_processor_count, topology.core_count, topology.cache_domain_count);
+    initialize_jobs(&topology);
 
     LOG_FATAL("This is a fatal message.");
     LOG_ERROR("This is a error message.");
@@ -22,19 +41,45 @@ int main(int argc, char** argv)
     app_config.pos_x = 100;
     app_config.pos_y = 100;
     app_config.name = "D3D12 Renderer";
+    app_config.input_record_path = nullptr;
+    app_config.input_replay_path = nullptr;
+
+    // -record <file> writes every input event to a file, -replay <file> plays
+    // one back instead of live input and exits when it runs out.
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        if (strcmp(argv[i], "-record") == 0)
+        {
+            app_config.input_record_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "-replay") == 0)
+        {
+            app_config.input_replay_path = argv[++i];
+        }
+    }
 
     Application app;
 
-    initialize(&app, app_config);
-    run(&app);
+    if (initialize(&app, app_config))
+    {
+        run(&app);
+    }
     shutdown(&app);
 
+    shutdown_jobs();
+    shutdown_async_io();
+    // A logger thread that missed its join may still read the queue.
+    bool logger_stopped = shutdown_logging();
+    shutdown_heaps(logger_stopped);
+
     return 0;
 }
 
+#if PLATFORM_WINDOWS
 int CALLBACK WinMain(HINSTANCE Instance, HINSTANCE PrevInstance, LPSTR CommandLine, int ShowCode)
 {
-    main(0, nullptr);
+    main(__argc, __argv);
 
     return 0;
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
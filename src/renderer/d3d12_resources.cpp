@@ -1 +1,184 @@
-#include "renderer/d3d12_resources.h"
\ No newline at end of file
+#include "renderer/d3d12_resources.h"
+#include "renderer/d3d12_helpers.h"
+
+void initialize_resource_pools(D3D12ResourcePools* pools, ID3D12Device* device)
+{
+	initialize_pool(&pools->buffers);
+	initialize_pool(&pools->textures);
+	initialize_pool(&pools->pipelines);
+	initialize_pool(&pools->descriptors);
+
+	D3D12_DESCRIPTOR_HEAP_DESC heap_desc = {};
+	heap_desc.NumDescriptors = RENDERER_MAX_DESCRIPTORS;
+	heap_desc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+	heap_desc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+	ThrowIfFailed(device->CreateDescriptorHeap(&heap_desc, IID_PPV_ARGS(&pools->descriptor_heap)));
+	pools->descriptor_size = device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+}
+
+void release_resource_pools(D3D12ResourcePools* pools)
+{
+	// Free slots are zeroed, so anything non-null is still owned.
+	for (u32 i = 0; i < RENDERER_MAX_BUFFERS; ++i)
+	{
+		if (pools->buffers.items[i].platform_resource)
+		{
+			pools->buffers.items[i].platform_resource->Release();
+		}
+	}
+	for (u32 i = 0; i < RENDERER_MAX_TEXTURES; ++i)
+	{
+		if (pools->textures.items[i].platform_resource)
+		{
+			pools->textures.items[i].platform_resource->Release();
+		}
+	}
+	for (u32 i = 0; i < RENDERER_MAX_PIPELINES; ++i)
+	{
+		if (pools->pipelines.items[i].platform_pipeline)
+		{
+			pools->pipelines.items[i].platform_pipeline->Release();
+		}
+	}
+
+	if (pools->descriptor_heap)
+	{
+		pools->descriptor_heap->Release();
+	}
+
+	initialize_pool(&pools->buffers);
+	initialize_pool(&pools->textures);
+	initialize_pool(&pools->pipelines);
+	initialize_pool(&pools->descriptors);
+	pools->descriptor_heap = nullptr;
+}
+
+BufferHandle add_buffer(D3D12ResourcePools* pools, ID3D12Resource* resource)
+{
+	BufferHandle handle = allocate_pool_item(&pools->buffers);
+	D3D12Buffer* buffer = get_pool_item(&pools->buffers, handle);
+	if (buffer == nullptr)
+	{
+		resource->Release();
+		return handle;
+	}
+
+	buffer->platform_resource = resource;
+	buffer->size = resource->GetDesc().Width;
+	buffer->gpu_address = resource->GetGPUVirtualAddress();
+	return handle;
+}
+
+TextureHandle add_texture(D3D12ResourcePools* pools, ID3D12Resource* resource)
+{
+	TextureHandle handle = allocate_pool_item(&pools->textures);
+	D3D12Texture* texture = get_pool_item(&pools->textures, handle);
+	if (texture == nullptr)
+	{
+		resource->Release();
+		return handle;
+	}
+
+	D3D12_RESOURCE_DESC desc = resource->GetDesc();
+	texture->platform_resource = resource;
+	texture->format = desc.Format;
+	texture->width = (u32)desc.Width;
+	texture->height = desc.Height;
+	return handle;
+}
+
+PipelineHandle add_pipeline(D3D12ResourcePools* pools, ID3D12PipelineState* pipeline_state, ID3D12RootSignature* root_signature)
+{
+	PipelineHandle handle = allocate_pool_item(&pools->pipelines);
+	D3D12Pipeline* pipeline = get_pool_item(&pools->pipelines, handle);
+	if (pipeline == nullptr)
+	{
+		pipeline_state->Release();
+		return handle;
+	}
+
+	pipeline->platform_pipeline = pipeline_state;
+	pipeline->root_signature = root_signature;
+	return handle;
+}
+
+DescriptorHandle allocate_descriptor(D3D12ResourcePools* pools)
+{
+	DescriptorHandle handle = allocate_pool_item(&pools->descriptors);
+	D3D12Descriptor* descriptor = get_pool_item(&pools->descriptors, handle);
+	if (descriptor == nullptr)
+	{
+		return handle;
+	}
+
+	u64 offset = (u64)(handle.value & POOL_INDEX_MASK) * pools->descriptor_size;
+	descriptor->cpu_handle = pools->descriptor_heap->GetCPUDescriptorHandleForHeapStart();
+	descriptor->cpu_handle.ptr += (SIZE_T)offset;
+	descriptor->gpu_handle = pools->descriptor_heap->GetGPUDescriptorHandleForHeapStart();
+	descriptor->gpu_handle.ptr += offset;
+	return handle;
+}
+
+void release_buffer(D3D12ResourcePools* pools, BufferHandle handle)
+{
+	D3D12Buffer* buffer = get_pool_item(&pools->buffers, handle);
+	if (buffer == nullptr)
+	{
+		return;
+	}
+
+	buffer->platform_resource->Release();
+	*buffer = {};
+	free_pool_item(&pools->buffers, handle);
+}
+
+void release_texture(D3D12ResourcePools* pools, TextureHandle handle)
+{
+	D3D12Texture* texture = get_pool_item(&pools->textures, handle);
+	if (texture == nullptr)
+	{
+		return;
+	}
+
+	texture->platform_resource->Release();
+	*texture = {};
+	free_pool_item(&pools->textures, handle);
+}
+
+void release_pipeline(D3D12ResourcePools* pools, PipelineHandle handle)
+{
+	D3D12Pipeline* pipeline = get_pool_item(&pools->pipelines, handle);
+	if (pipeline == nullptr)
+	{
+		return;
+	}
+
+	pipeline->platform_pipeline->Release();
+	*pipeline = {};
+	free_pool_item(&pools->pipelines, handle);
+}
+
+void free_descriptor(D3D12ResourcePools* pools, DescriptorHandle handle)
+{
+	free_pool_item(&pools->descriptors, handle);
+}
+
+D3D12Buffer* get_buffer(D3D12ResourcePools* pools, BufferHandle handle)
+{
+	return get_pool_item(&pools->buffers, handle);
+}
+
+D3D12Texture* get_texture(D3D12ResourcePools* pools, TextureHandle handle)
+{
+	return get_pool_item(&pools->textures, handle);
+}
+
+D3D12Pipeline* get_pipeline(D3D12ResourcePools* pools, PipelineHandle handle)
+{
+	return get_pool_item(&pools->pipelines, handle);
+}
+
+D3D12Descriptor* get_descriptor(D3D12ResourcePools* pools, DescriptorHandle handle)
+{
+	return get_pool_item(&pools->descriptors, handle);
+}
\ No newline at end of file
@@ -1,8 +1,80 @@
 #pragma once
 
+#include "core/core_types.h"
+#include "core/pool.h"
 #include "renderer/d3d12_headers.h"
 
+// Renderer objects live in pools and are referred to by handle, so a handle to
+// something that has been released fails the lookup instead of reaching a freed
+// COM object.
+#define RENDERER_MAX_BUFFERS 256
+#define RENDERER_MAX_TEXTURES 256
+#define RENDERER_MAX_PIPELINES 64
+#define RENDERER_MAX_DESCRIPTORS 256
+
 struct D3D12Buffer
 {
 	ID3D12Resource* platform_resource;
-};
\ No newline at end of file
+	u64 size;
+	D3D12_GPU_VIRTUAL_ADDRESS gpu_address;
+};
+
+struct D3D12Texture
+{
+	ID3D12Resource* platform_resource;
+	DXGI_FORMAT format;
+	u32 width;
+	u32 height;
+};
+
+struct D3D12Pipeline
+{
+	ID3D12PipelineState* platform_pipeline;
+	ID3D12RootSignature* root_signature; // Not owned, root signatures are shared.
+};
+
+// A CBV/SRV/UAV slot in the shader visible descriptor heap.
+struct D3D12Descriptor
+{
+	D3D12_CPU_DESCRIPTOR_HANDLE cpu_handle;
+	D3D12_GPU_DESCRIPTOR_HANDLE gpu_handle;
+};
+
+typedef Handle<D3D12Buffer> BufferHandle;
+typedef Handle<D3D12Texture> TextureHandle;
+typedef Handle<D3D12Pipeline> PipelineHandle;
+typedef Handle<D3D12Descriptor> DescriptorHandle;
+
+struct D3D12ResourcePools
+{
+	Pool<D3D12Buffer, RENDERER_MAX_BUFFERS> buffers;
+	Pool<D3D12Texture, RENDERER_MAX_TEXTURES> textures;
+	Pool<D3D12Pipeline, RENDERER_MAX_PIPELINES> pipelines;
+	Pool<D3D12Descriptor, RENDERER_MAX_DESCRIPTORS> descriptors;
+
+	// A descriptor's pool slot is its index in this heap.
+	ID3D12DescriptorHeap* descriptor_heap;
+	u32 descriptor_size;
+};
+
+void initialize_resource_pools(D3D12ResourcePools* pools, ID3D12Device* device);
+// Releases every object still in the pools. The GPU must be done with them.
+void release_resource_pools(D3D12ResourcePools* pools);
+
+// The pools take over the reference to the object. Zeroed handles when full.
+BufferHandle add_buffer(D3D12ResourcePools* pools, ID3D12Resource* resource);
+TextureHandle add_texture(D3D12ResourcePools* pools, ID3D12Resource* resource);
+PipelineHandle add_pipeline(D3D12ResourcePools* pools, ID3D12PipelineState* pipeline, ID3D12RootSignature* root_signature);
+DescriptorHandle allocate_descriptor(D3D12ResourcePools* pools);
+
+// Releasing a stale handle does nothing.
+void release_buffer(D3D12ResourcePools* pools, BufferHandle handle);
+void release_texture(D3D12ResourcePools* pools, TextureHandle handle);
+void release_pipeline(D3D12ResourcePools* pools, PipelineHandle handle);
+void free_descriptor(D3D12ResourcePools* pools, DescriptorHandle handle);
+
+// nullptr for stale handles.
+D3D12Buffer* get_buffer(D3D12ResourcePools* pools, BufferHandle handle);
+D3D12Texture* get_texture(D3D12ResourcePools* pools, TextureHandle handle);
+D3D12Pipeline* get_pipeline(D3D12ResourcePools* pools, PipelineHandle handle);
+D3D12Descriptor* get_descriptor(D3D12ResourcePools* pools, DescriptorHandle handle);
\ No newline at end of file
@@ -0,0 +1,40 @@
+#include "renderer/renderer.h"
+
+#if RENDERER_NULL
+
+#include "core/platform/platform.h"
+
+bool Renderer::initialize(u32 width, u32 height, void* window_handle)
+{
+	viewport_width = width;
+	viewport_height = height;
+	aspect_ratio = (f32)width / (f32)height;
+	offset_x = 0.0f;
+	frame_index = 0;
+	frame_number = 0;
+	last_present_time = read_timestamp();
+	return true;
+}
+
+void Renderer::update()
+{
+	const f32 translation_speed = 0.005f;
+	const f32 offset_bounds = 1.25f;
+
+	offset_x += translation_speed;
+	if (offset_x > offset_bounds)
+		offset_x = -offset_bounds;
+}
+
+void Renderer::render()
+{
+	last_present_time = read_timestamp();
+	frame_number++;
+	frame_index = (frame_index + 1) % FRAME_COUNT;
+}
+
+void Renderer::shutdown()
+{
+}
+
+#endif // RENDERER_NULL
\ No newline at end of file
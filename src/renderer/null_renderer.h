@@ -0,0 +1,30 @@
+#pragma once
+
+#include "core/core_types.h"
+
+// Stands in for the D3D12 renderer on platforms without it (RENDERER_NULL). It
+// keeps the same interface and frame pacing bookkeeping but submits nothing, so
+// the application loop can run headless.
+struct Renderer
+{
+	static const u32 FRAME_COUNT = 2;
+
+	u32 viewport_width;
+	u32 viewport_height;
+	f32 aspect_ratio;
+
+	// Mirrors the scene constants the D3D12 renderer animates.
+	f32 offset_x;
+
+	u32 frame_index = 0;
+	u64 frame_number;
+
+	// read_timestamp() right after the last (pretend) Present.
+	u64 last_present_time;
+
+	// window_handle is ignored, there is nothing to present to.
+	bool initialize(u32 viewport_width, u32 viewport_height, void* window_handle);
+	void update();
+	void render();
+	void shutdown();
+};
\ No newline at end of file
@@ -1,6 +1,14 @@
 #include "renderer/renderer.h"
 
 #include "renderer/d3d12_helpers.h"
+#include "core/heap.h"
+#include "core/jobs.h"
+#include "core/logger.h"
+#include "core/platform/platform.h"
+#include "core/scratch_arena.h"
+
+#define SHADER_DIRECTORY "F:/Dev/d3d12_renderer/assets/shaders/"
+#define TEXTURE_DIRECTORY "F:/Dev/d3d12_renderer/assets/textures/"
 
 // TEMPORARY
 struct Vertex
@@ -9,17 +17,28 @@ struct Vertex
 	f32 color[4];
 };
 
-std::vector<u8> Renderer::generate_texture_data()
+// Rows of the checkerboard are independent, so each job fills a band of them.
+#define TEXTURE_ROWS_PER_JOB 32
+
+struct TextureRowsJob
 {
-	const u32 row_pitch = TEXTURE_WIDTH * TEXTURE_PIXEL_SIZE;
-	const u32 cell_pitch = row_pitch >> 3; // The width of a cell in the checkerboard texture.
-	const u32 cell_height = TEXTURE_WIDTH >> 3; // The height of a cell in the checkerboard texture.
-	const u32 texture_size = row_pitch * TEXTURE_HEIGHT;
+	u8* data;
+	u32 first_row;
+	u32 row_count;
+};
 
-	std::vector<u8> data(texture_size);
-	u8* p_data = &data[0];
+static void generate_texture_rows(void* job_data)
+{
+	TextureRowsJob* rows = (TextureRowsJob*)job_data;
+	u8* p_data = rows->data;
+
+	const u32 row_pitch = Renderer::TEXTURE_WIDTH * Renderer::TEXTURE_PIXEL_SIZE;
+	const u32 cell_pitch = row_pitch >> 3; // The width of a cell in the checkerboard texture.
+	const u32 cell_height = Renderer::TEXTURE_WIDTH >> 3; // The height of a cell in the checkerboard texture.
+	const u32 begin = rows->first_row * row_pitch;
+	const u32 end = (rows->first_row + rows->row_count) * row_pitch;
 
-	for (u32 n = 0; n < texture_size; n += TEXTURE_PIXEL_SIZE)
+	for (u32 n = begin; n < end; n += Renderer::TEXTURE_PIXEL_SIZE)
 	{
 		u32 x = n % row_pitch;
 		u32 y = n / row_pitch;
@@ -41,11 +60,36 @@ std::vector<u8> Renderer::generate_texture_data()
 			p_data[n + 3] = 0xff; // A
 		}
 	}
+}
+
+u8* Renderer::generate_texture_data(Arena* arena)
+{
+	static_assert(TEXTURE_HEIGHT % TEXTURE_ROWS_PER_JOB == 0, "Texture rows must split evenly into jobs.");
+	const u32 texture_size = TEXTURE_WIDTH * TEXTURE_PIXEL_SIZE * TEXTURE_HEIGHT;
+	const u32 job_count = TEXTURE_HEIGHT / TEXTURE_ROWS_PER_JOB;
+
+	u8* p_data = allocate_array<u8>(arena, texture_size);
+	if (p_data == nullptr)
+	{
+		return nullptr;
+	}
 
-	return data;
+	TextureRowsJob rows[job_count];
+	Job jobs[job_count];
+	for (u32 i = 0; i < job_count; ++i)
+	{
+		rows[i] = { p_data, i * TEXTURE_ROWS_PER_JOB, TEXTURE_ROWS_PER_JOB };
+		jobs[i] = { generate_texture_rows, &rows[i], nullptr };
+	}
+
+	JobCounter counter = {};
+	run_jobs(jobs, job_count, &counter);
+	wait_for_counter(&counter);
+
+	return p_data;
 }
 
-bool Renderer::initialize(u32 viewport_width, u32 viewport_height, HWND hwnd)
+bool Renderer::initialize(u32 viewport_width, u32 viewport_height, void* window_handle)
 {
 	// Maybe do this in constructor.
 	viewport = CD3DX12_VIEWPORT(0.0f, 0.0f, static_cast<f32>(viewport_width), static_cast<f32>(viewport_height));
@@ -53,11 +97,69 @@ bool Renderer::initialize(u32 viewport_width, u32 viewport_height, HWND hwnd)
 	aspect_ratio = (f32)viewport_width / (f32)viewport_height;
 	constant_buffer_data.offset = DirectX::XMFLOAT4(0, 0, 0, 0);
 
-	load_pipeline(viewport_width, viewport_height, hwnd);
+	// The shader reads and texture prefetch run while the device and swap chain are created.
+	begin_shader_reads();
+	begin_baked_texture_load();
+	load_pipeline(viewport_width, viewport_height, (HWND)window_handle);
 	load_assets();
 	return true;
 }
 
+void Renderer::begin_shader_reads()
+{
+	const char* paths[SHADER_SOURCE_COUNT] =
+	{
+		SHADER_DIRECTORY "simple_textured_vs.hlsl",
+		SHADER_DIRECTORY "simple_textured_ps.hlsl"
+	};
+
+	for (u32 i = 0; i < SHADER_SOURCE_COUNT; ++i)
+	{
+		AsyncFileRead* read = &shader_reads[i];
+		*read = {};
+		read->path = paths[i];
+		if (get_file_size(read->path, &read->buffer_size))
+		{
+			read->buffer = allocate_from_heap(get_heap(HeapId::HEAP_ID_ASSETS), read->buffer_size, MEMORY_SITE(ASSETS));
+		}
+	}
+	submit_async_reads(shader_reads, SHADER_SOURCE_COUNT);
+}
+
+void Renderer::begin_baked_texture_load()
+{
+	const u64 texture_size = (u64)TEXTURE_WIDTH * TEXTURE_HEIGHT * TEXTURE_PIXEL_SIZE;
+	if (!open_mapped_file(&baked_texture, TEXTURE_DIRECTORY "checkerboard.rgba", MappedFileAccess::MAPPED_FILE_ACCESS_SEQUENTIAL))
+	{
+		return;
+	}
+
+	if (baked_texture.size != texture_size)
+	{
+		LOG_CAT_WARN(RENDERER, "Ignoring the baked texture, it is %llu bytes instead of %llu.", baked_texture.size, texture_size);
+		unmap_file(&baked_texture);
+		return;
+	}
+	prefetch_mapped_file(&baked_texture, 0, baked_texture.size);
+}
+
+ID3DBlob* Renderer::compile_shader(AsyncFileRead* read, const char* target, u32 compile_flags)
+{
+	if (!wait_for_async_read(read, 5000))
+	{
+		LOG_CAT_FATAL(RENDERER, "Failed to read shader %s.", read->path);
+		ThrowIfFailed(HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND));
+	}
+
+	// The path is passed as the source name so includes resolve next to the shader.
+	ID3DBlob* shader;
+	HRESULT result = D3DCompile(read->buffer, read->bytes_read, read->path, nullptr, D3D_COMPILE_STANDARD_FILE_INCLUDE, "main", target, compile_flags, 0, &shader, nullptr);
+	free_to_heap(get_heap(HeapId::HEAP_ID_ASSETS), read->buffer);
+	read->buffer = nullptr;
+	ThrowIfFailed(result);
+	return shader;
+}
+
 void Renderer::update()
 {
 	const f32 translation_speed = 0.005f;
@@ -80,6 +182,7 @@ void Renderer::render()
 
 	// Present the frame.
 	ThrowIfFailed(swap_chain->Present(1, 0));
+	last_present_time = read_timestamp();
 
 	wait_for_previous_frame(true);
 }
@@ -89,6 +192,9 @@ void Renderer::shutdown()
 	// Ensure that the GPU is no longer referencing resources that are about to be cleaned up.
 	wait_for_previous_frame(false);
 
+	release_resource_pools(resources);
+	free_to_heap(get_heap(HeapId::HEAP_ID_RENDERER), resources);
+	resources = nullptr;
 	CloseHandle(fence_event);
 }
 
@@ -165,12 +271,10 @@ void Renderer::load_pipeline(u32 viewport_width, u32 viewport_height, HWND hwnd)
 		rtv_desc_heap.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
 		ThrowIfFailed(device->CreateDescriptorHeap(&rtv_desc_heap, IID_PPV_ARGS(&rtv_descriptor_heap)));
 
-		// SRV descriptor heap.
-		D3D12_DESCRIPTOR_HEAP_DESC srv_heap_desc = {};
-		srv_heap_desc.NumDescriptors = 2;
-		srv_heap_desc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-		srv_heap_desc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-		ThrowIfFailed(device->CreateDescriptorHeap(&srv_heap_desc, IID_PPV_ARGS(&srv_descriptor_heap)));
+		// The resource pools own the shader visible CBV/SRV/UAV heap.
+		resources = allocate_heap_array<D3D12ResourcePools>(get_heap(HeapId::HEAP_ID_RENDERER), 1, MEMORY_SITE(RENDERER));
+		Assert(resources);
+		initialize_resource_pools(resources, device);
 
 		rtv_descriptor_size = device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
 	}
@@ -286,7 +390,9 @@ void Renderer::load_assets()
 		pso_desc.NumRenderTargets = 1;
 		pso_desc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
 		pso_desc.SampleDesc.Count = 1;
+		ID3D12PipelineState* pipeline_state;
 		ThrowIfFailed(device->CreateGraphicsPipelineState(&pso_desc, IID_PPV_ARGS(&pipeline_state)));
+		pipeline = add_pipeline(resources, pipeline_state, empty_root_signature);
 	}
 #else
 	{
@@ -300,8 +406,8 @@ void Renderer::load_assets()
 		u32 compile_flags = 0;
 #endif
 
-		ThrowIfFailed(D3DCompileFromFile(L"F:/Dev/d3d12_renderer/assets/shaders/simple_textured_vs.hlsl", nullptr, D3D_COMPILE_STANDARD_FILE_INCLUDE, "main", "vs_5_0", compile_flags, 0, &vertex_shader, nullptr));
-		ThrowIfFailed(D3DCompileFromFile(L"F:/Dev/d3d12_renderer/assets/shaders/simple_textured_ps.hlsl", nullptr, D3D_COMPILE_STANDARD_FILE_INCLUDE, "main", "ps_5_0", compile_flags, 0, &pixel_shader, nullptr));
+		vertex_shader = compile_shader(&shader_reads[0], "vs_5_0", compile_flags);
+		pixel_shader = compile_shader(&shader_reads[1], "ps_5_0", compile_flags);
 
 		// Define the vertex input layout.
 		D3D12_INPUT_ELEMENT_DESC input_element_descs[] =
@@ -325,7 +431,9 @@ void Renderer::load_assets()
 		pso_desc.NumRenderTargets = 1;
 		pso_desc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
 		pso_desc.SampleDesc.Count = 1;
+		ID3D12PipelineState* pipeline_state;
 		ThrowIfFailed(device->CreateGraphicsPipelineState(&pso_desc, IID_PPV_ARGS(&pipeline_state)));
+		pipeline = add_pipeline(resources, pipeline_state, single_texture_root_signature);
 	}
 #endif
 
@@ -352,23 +460,26 @@ void Renderer::load_assets()
 		// recommended. Every time the GPU needs it, the upload heap will be marshalled 
 		// over. Please read up on Default Heap usage. An upload heap is used here for 
 		// code simplicity and because there are very few verts to actually transfer.
+		ID3D12Resource* vertex_resource;
 		ThrowIfFailed(device->CreateCommittedResource(
 			&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
 			D3D12_HEAP_FLAG_NONE,
 			&CD3DX12_RESOURCE_DESC::Buffer(vertex_buffer_size),
 			D3D12_RESOURCE_STATE_GENERIC_READ,
 			nullptr,
-			IID_PPV_ARGS(&vertex_buffer)));
+			IID_PPV_ARGS(&vertex_resource)));
+		vertex_buffer = add_buffer(resources, vertex_resource);
 
 		// Copy the triangle data to the vertex buffer.
 		u8* vertex_data_begin;
 		CD3DX12_RANGE read_range(0, 0); // We do not intend to read from this buffer on the CPU.
-		ThrowIfFailed(vertex_buffer->Map(0, &read_range, reinterpret_cast<void**>(&vertex_data_begin)));
-		memcpy(vertex_data_begin, triangle_vertices, sizeof(triangle_vertices));
-		vertex_buffer->Unmap(0, nullptr);
+		ThrowIfFailed(vertex_resource->Map(0, &read_range, reinterpret_cast<void**>(&vertex_data_begin)));
+		// Upload heaps are write-combined, stream into them rather than through the cache.
+		stream_copy_memory(vertex_data_begin, triangle_vertices, sizeof(triangle_vertices));
+		vertex_resource->Unmap(0, nullptr);
 
 		// Initialize the vertex buffer view.
-		vertex_buffer_view.BufferLocation = vertex_buffer->GetGPUVirtualAddress();
+		vertex_buffer_view.BufferLocation = get_buffer(resources, vertex_buffer)->gpu_address;
 		vertex_buffer_view.StrideInBytes  = sizeof(Vertex);
 		vertex_buffer_view.SizeInBytes    = vertex_buffer_size;
 	}
@@ -377,27 +488,28 @@ void Renderer::load_assets()
 	{
 		const u32 constant_buffer_size = sizeof(SceneConstantBuffer);
 
+		ID3D12Resource* constant_resource;
 		ThrowIfFailed(device->CreateCommittedResource(
 			&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
 			D3D12_HEAP_FLAG_NONE,
 			&CD3DX12_RESOURCE_DESC::Buffer(constant_buffer_size),
 			D3D12_RESOURCE_STATE_GENERIC_READ,
 			nullptr,
-			IID_PPV_ARGS(&constant_buffer)
+			IID_PPV_ARGS(&constant_resource)
 		));
+		constant_buffer = add_buffer(resources, constant_resource);
 
 		// Describe and create a constant buffer view.
 		D3D12_CONSTANT_BUFFER_VIEW_DESC cbv_desc = {};
-		cbv_desc.BufferLocation = constant_buffer->GetGPUVirtualAddress();
+		cbv_desc.BufferLocation = get_buffer(resources, constant_buffer)->gpu_address;
 		cbv_desc.SizeInBytes = constant_buffer_size;
-		D3D12_CPU_DESCRIPTOR_HANDLE handle = srv_descriptor_heap->GetCPUDescriptorHandleForHeapStart();
-		handle.ptr += rtv_descriptor_size;
-		device->CreateConstantBufferView(&cbv_desc, handle);
+		constant_buffer_cbv = allocate_descriptor(resources);
+		device->CreateConstantBufferView(&cbv_desc, get_descriptor(resources, constant_buffer_cbv)->cpu_handle);
 
 		// Map and initialize the constant buffer. We don't unmap this until the
 		// app closes. Keeping things mapped for the lifetime of the resource is okay.
 		CD3DX12_RANGE readRange(0, 0);        // We do not intend to read from this resource on the CPU.
-		ThrowIfFailed(constant_buffer->Map(0, &readRange, reinterpret_cast<void**>(&cbv_data_begin)));
+		ThrowIfFailed(constant_resource->Map(0, &readRange, reinterpret_cast<void**>(&cbv_data_begin)));
 		memcpy(cbv_data_begin, &constant_buffer_data, sizeof(constant_buffer_data));
 	}
 
@@ -416,16 +528,21 @@ void Renderer::load_assets()
 		texture_desc.SampleDesc.Quality = 0;
 		texture_desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
 
+		ID3D12Resource* texture_resource;
 		ThrowIfFailed(device->CreateCommittedResource(
 			&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
 			D3D12_HEAP_FLAG_NONE,
 			&texture_desc,
 			D3D12_RESOURCE_STATE_COPY_DEST,
 			nullptr,
-			IID_PPV_ARGS(&texture)));
+			IID_PPV_ARGS(&texture_resource)));
+		texture = add_texture(resources, texture_resource);
 
+		D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprint;
+		u32 row_count;
+		u64 row_size;
 		u64 upload_buffer_size;
-		device->GetCopyableFootprints(&texture->GetDesc(), 0, 1, 0, nullptr, nullptr, nullptr, &upload_buffer_size);
+		device->GetCopyableFootprints(&texture_desc, 0, 1, 0, &footprint, &row_count, &row_size, &upload_buffer_size);
 
 		// Create the GPU upload buffer.
 		ThrowIfFailed(device->CreateCommittedResource(
@@ -438,15 +555,38 @@ void Renderer::load_assets()
 
 		// Copy data to the intermediate upload heap and then schedul a copy
 		// from the upload heap to the Texture2D.
-		std::vector<u8> raw_texture_data = generate_texture_data();
+		// The baked texture is copied straight out of the file mapping.
+		ScratchScope scratch;
+		const u8* raw_texture_data = baked_texture.data;
+		if (raw_texture_data == nullptr)
+		{
+			raw_texture_data = generate_texture_data(scratch.arena);
+			ThrowIfFailed(raw_texture_data ? S_OK : E_OUTOFMEMORY);
+		}
+		const u32 source_row_pitch = TEXTURE_WIDTH * TEXTURE_PIXEL_SIZE;
 
-		D3D12_SUBRESOURCE_DATA texture_data = {};
-		texture_data.pData = &raw_texture_data[0];
-		texture_data.RowPitch = TEXTURE_WIDTH * TEXTURE_PIXEL_SIZE;
-		texture_data.SlicePitch = texture_data.RowPitch * TEXTURE_HEIGHT;
+		u8* upload_data;
+		CD3DX12_RANGE upload_read_range(0, 0);
+		ThrowIfFailed(texture_upload_heap->Map(0, &upload_read_range, reinterpret_cast<void**>(&upload_data)));
+		u8* dest = upload_data + footprint.Offset;
+		if (footprint.Footprint.RowPitch == source_row_pitch)
+		{
+			stream_copy_memory(dest, raw_texture_data, (size_t)source_row_pitch * row_count);
+		}
+		else
+		{
+			for (u32 row = 0; row < row_count; ++row)
+			{
+				stream_copy_memory(dest + (u64)row * footprint.Footprint.RowPitch, &raw_texture_data[(size_t)row * source_row_pitch], (size_t)row_size);
+			}
+		}
+		texture_upload_heap->Unmap(0, nullptr);
+		unmap_file(&baked_texture);
 
-		UpdateSubresources(command_list, texture, texture_upload_heap, 0, 0, 1, &texture_data);
-		command_list->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(texture, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
+		CD3DX12_TEXTURE_COPY_LOCATION copy_dest(texture_resource, 0);
+		CD3DX12_TEXTURE_COPY_LOCATION copy_source(texture_upload_heap, footprint);
+		command_list->CopyTextureRegion(&copy_dest, 0, 0, 0, &copy_source, nullptr);
+		command_list->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(texture_resource, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
 
 		// Describe and create a SRV for the texture.
 		D3D12_SHADER_RESOURCE_VIEW_DESC srv_desc = {};
@@ -454,7 +594,8 @@ void Renderer::load_assets()
 		srv_desc.Format = texture_desc.Format;
 		srv_desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
 		srv_desc.Texture2D.MipLevels = 1;
-		device->CreateShaderResourceView(texture, &srv_desc, srv_descriptor_heap->GetCPUDescriptorHandleForHeapStart());
+		texture_srv = allocate_descriptor(resources);
+		device->CreateShaderResourceView(texture_resource, &srv_desc, get_descriptor(resources, texture_srv)->cpu_handle);
 	}
 
 	// Close the command list and execute it to begin the inital GPU setup (texture upload).
@@ -491,18 +632,22 @@ void Renderer::populate_command_list()
 	// However, when ExecuteCommandList() is called on a particular command 
 	// list, that command list can then be reset at any time and must be before 
 	// re-recording.
-	ThrowIfFailed(command_list->Reset(command_allocator, pipeline_state));
+	// Stale handles are caught here rather than handing freed objects to the command list.
+	D3D12Pipeline* current_pipeline = get_pipeline(resources, pipeline);
+	D3D12Descriptor* srv = get_descriptor(resources, texture_srv);
+	D3D12Descriptor* cbv = get_descriptor(resources, constant_buffer_cbv);
+	Assert(current_pipeline && srv && cbv);
+
+	ThrowIfFailed(command_list->Reset(command_allocator, current_pipeline->platform_pipeline));
 
 	// Set necessary state.
-	command_list->SetGraphicsRootSignature(single_texture_root_signature);
+	command_list->SetGraphicsRootSignature(current_pipeline->root_signature);
 
-	ID3D12DescriptorHeap* heaps[] = { srv_descriptor_heap };
+	ID3D12DescriptorHeap* heaps[] = { resources->descriptor_heap };
 	command_list->SetDescriptorHeaps(_countof(heaps), heaps);
 
-	command_list->SetGraphicsRootDescriptorTable(0, srv_descriptor_heap->GetGPUDescriptorHandleForHeapStart());
-	CD3DX12_GPU_DESCRIPTOR_HANDLE gpu_handle(srv_descriptor_heap->GetGPUDescriptorHandleForHeapStart());
-	gpu_handle.Offset(1, rtv_descriptor_size);
-	command_list->SetGraphicsRootDescriptorTable(1, gpu_handle);
+	command_list->SetGraphicsRootDescriptorTable(0, srv->gpu_handle);
+	command_list->SetGraphicsRootDescriptorTable(1, cbv->gpu_handle);
 	command_list->RSSetViewports(1, &viewport);
 	command_list->RSSetScissorRects(1, &scissor_rect);
 
@@ -1,11 +1,18 @@
 #pragma once
 
+#include "core/arena.h"
 #include "core/core_types.h"
+#include "core/platform/platform.h"
+
+#if RENDERER_NULL
+#include "renderer/null_renderer.h"
+#else
 
 #include <initguid.h>
 #include "renderer/d3d12_headers.h"
 
 #include "renderer/d3dx12.h"
+#include "renderer/d3d12_resources.h"
 
 // @Cleanup: Don't link these libs in source code.
 #pragma comment(lib, "d3d12.lib")
@@ -32,6 +39,7 @@ struct Renderer
 	static const u32 TEXTURE_WIDTH = 256;
 	static const u32 TEXTURE_HEIGHT = 256;
 	static const u32 TEXTURE_PIXEL_SIZE = 4; // The number of bytes used to represent a pixel in the texture.
+	static const u32 SHADER_SOURCE_COUNT = 2;
 
 	// Pipeline objects.
 	CD3DX12_VIEWPORT viewport;
@@ -44,16 +52,20 @@ struct Renderer
 	ID3D12RootSignature* empty_root_signature;
 	ID3D12RootSignature* single_texture_root_signature;
 	ID3D12DescriptorHeap* rtv_descriptor_heap;
-	ID3D12DescriptorHeap* srv_descriptor_heap;
-	ID3D12PipelineState* pipeline_state;
 	ID3D12GraphicsCommandList* command_list;
 	u32 rtv_descriptor_size = 0;
 
+	// Buffers, textures, pipelines and CBV/SRV/UAV descriptors.
+	D3D12ResourcePools* resources = nullptr; // From the renderer heap.
+	PipelineHandle pipeline;
+
 	// App resources.
-	ID3D12Resource* vertex_buffer;
+	BufferHandle vertex_buffer;
 	D3D12_VERTEX_BUFFER_VIEW vertex_buffer_view;
-	ID3D12Resource* texture;
-	ID3D12Resource* constant_buffer;
+	TextureHandle texture;
+	DescriptorHandle texture_srv;
+	BufferHandle constant_buffer;
+	DescriptorHandle constant_buffer_cbv;
 	SceneConstantBuffer constant_buffer_data;
 	UINT8* cbv_data_begin = nullptr;
 
@@ -63,14 +75,28 @@ struct Renderer
 	ID3D12Fence* frame_fence;
 	u64 fence_value;
 
+	// read_timestamp() right after the last Present returned.
+	u64 last_present_time;
+
+	// Shader sources are read asynchronously while the device is being created
+	// and compiled from memory once load_assets needs them.
+	AsyncFileRead shader_reads[SHADER_SOURCE_COUNT];
+	// A baked RGBA8 texture, used in place if it exists and matches the texture
+	// size. Otherwise the texture is generated.
+	PlatformMappedFile baked_texture;
+
 	// TEMPORARY
 	f32 aspect_ratio;
 
-	bool initialize(u32 viewport_width, u32 viewport_height, HWND hwnd);
+	// window_handle is the HWND of the window to present to.
+	bool initialize(u32 viewport_width, u32 viewport_height, void* window_handle);
 	void update();
 	void render();
 	void shutdown();
 
+	void begin_shader_reads();
+	void begin_baked_texture_load();
+	ID3DBlob* compile_shader(AsyncFileRead* read, const char* target, u32 compile_flags);
 	void load_pipeline(u32 viewport_width, u32 viewport_height, HWND hwnd);
 	void load_assets();
 	void populate_command_list();
@@ -78,5 +104,8 @@ struct Renderer
 
 	void get_hardware_adapter(IDXGIFactory1* factory, IDXGIAdapter1** adapter, bool request_high_performance_adapter = false);
 
-	static std::vector<u8> generate_texture_data();
-};
\ No newline at end of file
+	// Allocated from arena, the data is only needed until it is copied to the upload heap.
+	static u8* generate_texture_data(Arena* arena);
+};
+
+#endif // RENDERER_NULL
\ No newline at end of file
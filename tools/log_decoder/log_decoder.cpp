@@ -0,0 +1,349 @@
+// Turns a binary log written with LOG_BINARY_ENABLED back into text.
+//
+// Usage: log_decoder <input.binlog> [output.txt]
+
+#include "core/core_types.h"
+#include "core/logger_binary.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct FormatEntry
+{
+	u64 id;
+	char* format;
+};
+
+struct FormatTable
+{
+	FormatEntry* entries;
+	u32 count;
+	u32 capacity;
+};
+
+static const char* find_format(FormatTable* table, u64 id)
+{
+	for (u32 i = 0; i < table->count; ++i)
+	{
+		if (table->entries[i].id == id)
+		{
+			return table->entries[i].format;
+		}
+	}
+	return nullptr;
+}
+
+static void add_format(FormatTable* table, u64 id, char* format)
+{
+	for (u32 i = 0; i < table->count; ++i)
+	{
+		if (table->entries[i].id == id)
+		{
+			free(table->entries[i].format);
+			table->entries[i].format = format;
+			return;
+		}
+	}
+
+	if (table->count == table->capacity)
+	{
+		table->capacity = table->capacity ? table->capacity * 2 : 256;
+		table->entries = (FormatEntry*)realloc(table->entries, table->capacity * sizeof(FormatEntry));
+	}
+	table->entries[table->count].id = id;
+	table->entries[table->count].format = format;
+	table->count++;
+}
+
+struct ArgReader
+{
+	const u8* data;
+	u32 size;
+	u32 offset;
+};
+
+struct DecodedArg
+{
+	LogArgType type;
+	u64 integer;
+	f64 number;
+	const char* string;
+	u16 string_length;
+};
+
+static bool read_arg(ArgReader* reader, DecodedArg* arg)
+{
+	if (reader->offset >= reader->size)
+	{
+		return false;
+	}
+
+	arg->type = (LogArgType)reader->data[reader->offset++];
+	const u8* payload = reader->data + reader->offset;
+	u32 remaining = reader->size - reader->offset;
+
+	switch (arg->type)
+	{
+	case LogArgType::LOG_ARG_S32:
+	case LogArgType::LOG_ARG_U32:
+	{
+		if (remaining < sizeof(u32)) return false;
+		u32 value;
+		memcpy(&value, payload, sizeof(value));
+		arg->integer = (arg->type == LogArgType::LOG_ARG_S32) ? (u64)(s64)(s32)value : value;
+		reader->offset += sizeof(u32);
+		return true;
+	}
+	case LogArgType::LOG_ARG_S64:
+	case LogArgType::LOG_ARG_U64:
+	case LogArgType::LOG_ARG_POINTER:
+	{
+		if (remaining < sizeof(u64)) return false;
+		memcpy(&arg->integer, payload, sizeof(u64));
+		reader->offset += sizeof(u64);
+		return true;
+	}
+	case LogArgType::LOG_ARG_F64:
+	{
+		if (remaining < sizeof(f64)) return false;
+		memcpy(&arg->number, payload, sizeof(f64));
+		reader->offset += sizeof(f64);
+		return true;
+	}
+	case LogArgType::LOG_ARG_STRING:
+	{
+		if (remaining < sizeof(u16)) return false;
+		memcpy(&arg->string_length, payload, sizeof(u16));
+		if (remaining < sizeof(u16) + arg->string_length) return false;
+		arg->string = (const char*)payload + sizeof(u16);
+		reader->offset += sizeof(u16) + arg->string_length;
+		return true;
+	}
+	}
+
+	return false;
+}
+
+// Formats a single conversion. The spec has had its length modifiers removed,
+// the right one for the stored argument type is added back here.
+static void format_arg(FILE* out, const char* flags, char conversion, DecodedArg* arg)
+{
+	char spec[64];
+	bool is_integer_conversion = strchr("diouxXc", conversion) != nullptr;
+	bool is_float_conversion = strchr("fFeEgGaA", conversion) != nullptr;
+
+	if (conversion == 's' && arg->type == LogArgType::LOG_ARG_STRING)
+	{
+		char string[LOG_BINARY_ARGS_SIZE + 1];
+		memcpy(string, arg->string, arg->string_length);
+		string[arg->string_length] = '\0';
+		snprintf(spec, sizeof(spec), "%%%ss", flags);
+		fprintf(out, spec, string);
+	}
+	else if (conversion == 'p' && arg->type == LogArgType::LOG_ARG_POINTER)
+	{
+		snprintf(spec, sizeof(spec), "%%%sllx", flags);
+		fprintf(out, "0x");
+		fprintf(out, spec, (unsigned long long)arg->integer);
+	}
+	else if (is_float_conversion && arg->type == LogArgType::LOG_ARG_F64)
+	{
+		snprintf(spec, sizeof(spec), "%%%s%c", flags, conversion);
+		fprintf(out, spec, arg->number);
+	}
+	else if (is_integer_conversion && arg->type != LogArgType::LOG_ARG_F64 && arg->type != LogArgType::LOG_ARG_STRING)
+	{
+		if (conversion == 'c')
+		{
+			snprintf(spec, sizeof(spec), "%%%sc", flags);
+			fprintf(out, spec, (int)arg->integer);
+		}
+		else
+		{
+			snprintf(spec, sizeof(spec), "%%%sll%c", flags, conversion);
+			fprintf(out, spec, (long long)arg->integer);
+		}
+	}
+	else
+	{
+		fprintf(out, "<bad arg for %%%c>", conversion);
+	}
+}
+
+static void format_entry(FILE* out, const char* format, ArgReader* reader)
+{
+	for (const char* c = format; *c; ++c)
+	{
+		if (*c != '%')
+		{
+			fputc(*c, out);
+			continue;
+		}
+
+		++c;
+		if (*c == '%')
+		{
+			fputc('%', out);
+			continue;
+		}
+
+		// Flags, width and precision are kept. '*' consumes an integer argument.
+		char flags[48];
+		u32 flags_length = 0;
+		while (*c && strchr("-+ #0123456789.*", *c) && flags_length < sizeof(flags) - 12)
+		{
+			if (*c == '*')
+			{
+				DecodedArg width = {};
+				read_arg(reader, &width);
+				flags_length += snprintf(flags + flags_length, sizeof(flags) - flags_length, "%d", (s32)width.integer);
+			}
+			else
+			{
+				flags[flags_length++] = *c;
+			}
+			++c;
+		}
+		flags[flags_length] = '\0';
+
+		// Length modifiers.
+		while (*c && strchr("hlLqjzt", *c))
+		{
+			++c;
+		}
+		if (c[0] == 'I' && c[1] == '6' && c[2] == '4')
+		{
+			c += 3;
+		}
+
+		if (*c == '\0')
+		{
+			break;
+		}
+
+		DecodedArg arg = {};
+		if (!read_arg(reader, &arg))
+		{
+			fprintf(out, "<missing arg>");
+			continue;
+		}
+		format_arg(out, flags, *c, &arg);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "Usage: log_decoder <input.binlog> [output.txt]\n");
+		return 1;
+	}
+
+	FILE* in = fopen(argv[1], "rb");
+	if (in == nullptr)
+	{
+		fprintf(stderr, "Failed to open %s\n", argv[1]);
+		return 1;
+	}
+
+	FILE* out = stdout;
+	if (argc > 2)
+	{
+		out = fopen(argv[2], "w");
+		if (out == nullptr)
+		{
+			fprintf(stderr, "Failed to open %s\n", argv[2]);
+			fclose(in);
+			return 1;
+		}
+	}
+
+	LogBinaryHeader header;
+	if (fread(&header, sizeof(header), 1, in) != 1 || header.magic != LOG_BINARY_MAGIC || header.version != LOG_BINARY_VERSION)
+	{
+		fprintf(stderr, "%s is not a binary log.\n", argv[1]);
+		fclose(in);
+		return 1;
+	}
+
+	const char* level_strings[6] = { "[FATAL]: ", "[ERROR]: ", "[WARN]: ", "[INFO]: ", "[DEBUG]: ","[TRACE]: " };
+	FormatTable formats = {};
+	u8 args[LOG_BINARY_ARGS_SIZE];
+	u64 entry_count = 0;
+
+	u8 kind;
+	while (fread(&kind, sizeof(kind), 1, in) == 1)
+	{
+		if (kind == (u8)LogBinaryRecordKind::LOG_BINARY_RECORD_FORMAT)
+		{
+			u64 format_id;
+			u32 length;
+			if (fread(&format_id, sizeof(format_id), 1, in) != 1 || fread(&length, sizeof(length), 1, in) != 1)
+			{
+				break;
+			}
+
+			char* format = (char*)malloc(length + 1);
+			if (fread(format, 1, length, in) != length)
+			{
+				free(format);
+				break;
+			}
+			format[length] = '\0';
+			add_format(&formats, format_id, format);
+		}
+		else if (kind == (u8)LogBinaryRecordKind::LOG_BINARY_RECORD_ENTRY)
+		{
+			u8 level;
+			u64 timestamp;
+			u64 format_id;
+			u16 size;
+			if (fread(&level, sizeof(level), 1, in) != 1 ||
+				fread(&timestamp, sizeof(timestamp), 1, in) != 1 ||
+				fread(&format_id, sizeof(format_id), 1, in) != 1 ||
+				fread(&size, sizeof(size), 1, in) != 1 ||
+				size > sizeof(args) ||
+				fread(args, 1, size, in) != size)
+			{
+				break;
+			}
+
+			f64 seconds = (f64)(s64)(timestamp - header.start_timestamp) / (f64)header.timestamp_frequency;
+			fprintf(out, "[%12.6f] %s", seconds, level_strings[level < 6 ? level : 5]);
+
+			const char* format = find_format(&formats, format_id);
+			if (format)
+			{
+				ArgReader reader = { args, size, 0 };
+				format_entry(out, format, &reader);
+			}
+			else
+			{
+				fprintf(out, "<unknown format 0x%llx>", (unsigned long long)format_id);
+			}
+			fputc('\n', out);
+			entry_count++;
+		}
+		else
+		{
+			fprintf(stderr, "Corrupt record kind %u, stopping.\n", kind);
+			break;
+		}
+	}
+
+	fprintf(stderr, "Decoded %llu entries.\n", (unsigned long long)entry_count);
+
+	for (u32 i = 0; i < formats.count; ++i)
+	{
+		free(formats.entries[i].format);
+	}
+	free(formats.entries);
+
+	fclose(in);
+	if (out != stdout)
+	{
+		fclose(out);
+	}
+	return 0;
+}
\ No newline at end of file